@@ -1,15 +1,18 @@
 /*Author: JJ McCauley (BST Code provided by Dr. Spickler)
 Creation Date: 4/5/24
-Last Update: 4/5/24
+Last Update: 10/17/26
 Description: This program aims to time AVL Insertion and BST Insertion + DSW Algorithm, allowing for the
 user to choose array size and data range. An array will then be created with random integers within that
-range, and the time elasped will be outputted to the console.
+range, and the time elasped will be outputted to the console, along with the hardware counters
+(cycles, instructions, cache, branch and TLB misses) of each timed region where they are available.
 User Interface: N/A
 Notes: N/A */
 
 //Header files include code for AVL and DSW Algorithm
 #include "AVLTree.h"
 #include "BinaryTree.h"
+//Hardware performance counters around the timed regions
+#include "PerfCounters.h"
 
 //Cleaning code
 using namespace std;
@@ -31,6 +34,7 @@ int main() {
     bool iterateAgain = false; //Allow the restart the process without restarting the program
     AVLTree<int> avlt;
     BinaryTree<int> bst;
+    PerfCounterGroup counters; //Counters read around each timed region
 
     cout << "Welcome to JJ's Timing Algorithm" << endl;
 
@@ -44,6 +48,7 @@ int main() {
 
         //Starting the timer
         cout << "Timing AVL..." << endl;
+        counters.start();
         auto start = chrono::high_resolution_clock::now();
 
         //Iterating through the array and inserting numNodes nodes
@@ -53,14 +58,18 @@ int main() {
 
         //Ending the timer
         auto end = std::chrono::high_resolution_clock::now();
+        PerfSample sample = counters.stop();
         auto timeElasped = (std::chrono::duration_cast<chrono::microseconds>(end-start)).count();
         double tElasped = static_cast<double>(timeElasped) /1000000.0; //converting to seconds
         cout << "Time Elasped for AVL Insertion: " << tElasped << " seconds" << endl;
+        printPerfSample(cout, sample);
+        cout << endl;
 
         /* Testing BST + DSW Times */
 
         //Starting the timer
         cout << "Timing BST & DSW..." << endl;
+        counters.start();
         start = chrono::high_resolution_clock::now();
 
         //Iterating through the array and inserting numNodes nodes. Then, creating backbone.
@@ -71,10 +80,13 @@ int main() {
 
         //Ending the timer
         end = std::chrono::high_resolution_clock::now();
+        sample = counters.stop();
         timeElasped = (std::chrono::duration_cast<chrono::microseconds>(end-start)).count();
         tElasped = static_cast<double>(timeElasped) /1000000.0; //converting to seconds
         cout << "Time Elasped for BST Insertion + DSW Algorithm: ";
         cout << tElasped << " seconds" << endl;
+        printPerfSample(cout, sample);
+        cout << endl;
 
         //Asking the user if they would like to run the program again
         char userChoice;
@@ -7,6 +7,7 @@
 #include <cmath>
 #include "RBTree.h" //header file for Red-Black Tree
 #include "AVLTree.h" //header file for AVL Tree
+#include "PerfCounters.h" //hardware counters (cycles, cache and branch misses) for the timed regions
 
 using namespace std;
 
@@ -24,6 +25,7 @@ int main() {
     int numNodes, lowerBound, upperBound, cycles, randNum, avlIPL, rbIPL;
     double averageAVLIPL, averageRBIPL;
     bool loopAgain = true, nodeFound = false;
+    PerfCounterGroup counters; //read around each timed region
     cout << "Welcome to JJ's Tree Timer!" << endl;
 
     while(loopAgain) {
@@ -42,7 +44,8 @@ int main() {
 
         cout << "Timing Now..." << endl;
         cout << "------------------------" << endl << "AVL Tree: " << endl;
-        //Starting the timer
+        //Starting the timer and the counters
+        counters.start();
         auto startAVLTimer = chrono::high_resolution_clock::now();
 
         //Inserting nodes
@@ -75,15 +78,19 @@ int main() {
 
         //End the timer and print the time
         auto endAVLTimer = std::chrono::high_resolution_clock::now();
+        PerfSample avlSample = counters.stop();
 	    auto timeElaspedAVL = (chrono::duration_cast<chrono::microseconds>(endAVLTimer-startAVLTimer)).count();
    	    double tElapsedAVL = static_cast<double>(timeElaspedAVL) /1000000.0; //convert to seconds
-        cout << endl << "Time Elasped for " << numNodes << " nodes and " << cycles << " cycles: " << tElapsedAVL << " seconds" << endl << endl;
+        cout << endl << "Time Elasped for " << numNodes << " nodes and " << cycles << " cycles: " << tElapsedAVL << " seconds" << endl;
+        printPerfSample(cout, avlSample);
+        cout << endl << endl;
 
 
         /*----------------------Red-Black-Tree----------------------*/
 
         cout << "------------------------" << endl << "Red-Black Tree: " << endl;
-        //Starting the timer
+        //Starting the timer and the counters
+        counters.start();
         auto startRBTimer = chrono::high_resolution_clock::now();
 
         //Inserting nodes
@@ -116,9 +123,12 @@ int main() {
 
         //End the timer and print the time
         auto endRBTimer = std::chrono::high_resolution_clock::now();
+        PerfSample rbSample = counters.stop();
 	    auto timeElaspedRB = (chrono::duration_cast<chrono::microseconds>(endRBTimer-startRBTimer)).count();
    	    double tElapsedRB = static_cast<double>(timeElaspedRB) /1000000.0; //convert to seconds
         cout << endl << "Time Elasped for " << numNodes << " nodes and " << cycles << " cycles: " << tElapsedRB << " seconds" << endl;    
+        printPerfSample(cout, rbSample);
+        cout << endl;
 
         /* --- Ask user if they would like to loop again ---*/
         loopAgain = getLoopAgain();
@@ -12,6 +12,7 @@
 #include <climits> //For copied implementation
 
 #include "WGraph.h"
+#include "PerfCounters.h" //Hardware counters (cycles, cache and branch misses) for the timed regions
 
 using namespace std;
 
@@ -75,11 +76,14 @@ int main() {
   div();
 
   cout << "Minimal Spanning Tree - Kruskal Algorithm" << endl;
+  PerfCounterGroup counters; //Read around each timed region
+  counters.start();
   auto startKTimer = chrono::high_resolution_clock::now(); //Starting the timer
   WGraph<int, int> MST1 = KruskalAlgorithm(G); //Getting minimal spanning tree
 
   //ending the timer
   auto endKTimer = std::chrono::high_resolution_clock::now();
+  PerfSample kruskalSample = counters.stop();
 	auto timeElaspedK = (chrono::duration_cast<chrono::microseconds>(endKTimer-startKTimer)).count();
   double tElapsedK = static_cast<double>(timeElaspedK) /1000000.0; //convert to seconds
   
@@ -87,22 +91,28 @@ int main() {
   cout << "Size of Kruskal's MST: " << MST1.size() << endl;
   cout << "Total weight of Kruskal's MST: " << totalWeight(MST1) << endl;
   cout << "Elasped time for Kruskal's Algorithm: " << tElapsedK << endl;
+  printPerfSample(cout, kruskalSample);
+  cout << endl;
 
   div();
 
   cout << "Minimal Spanning Tree - Jarnik Prim Algorithm" << endl;
+  counters.start();
   auto startPTimer = chrono::high_resolution_clock::now(); //Starting the timer
   WGraph<int, int> MST = JarnikPrimAlgorithm(G); //Getting minimal spanning tree
 
   //ending the timer
   auto endPTimer = std::chrono::high_resolution_clock::now();
+  PerfSample primSample = counters.stop();
 	auto timeElaspedP = (chrono::duration_cast<chrono::microseconds>(endPTimer-startPTimer)).count();
   double tElapsedP = static_cast<double>(timeElaspedP) /1000000.0; //convert to seconds
   
   MST.saveGraphFileGML("JarnikPrim_Minimal_Spanning_Tree"); //Saving to graph file
   cout << "Size of Jarnik Prim's MST: " << MST.size() << endl;
   cout << "Total weight of Jarnik Prim's MST: " << totalWeight(MST) << endl;
-  cout << "Elasped time for Jarnik Prim's Algorithm: " << tElapsedP << endl << endl;
+  cout << "Elasped time for Jarnik Prim's Algorithm: " << tElapsedP << endl;
+  printPerfSample(cout, primSample);
+  cout << endl << endl;
 
   return 0;
 }
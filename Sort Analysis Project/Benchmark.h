@@ -0,0 +1,388 @@
+/*
+Author: JJ McCauley
+Creation Date: 10/17/26
+Last Update: 10/17/26
+Description: Benchmark harness used by the timing programs. Every case is
+timed over repeated trials, each on a fresh copy of its input, until the 95%
+confidence interval of the mean is tight enough, and is summarized by its
+median, 5th and 95th percentiles, time per element and throughput.
+Notes: On Linux the harness pins itself to one CPU so trials do not migrate
+between cores; parallel cases are given the original CPU mask back while
+they run so their worker threads can spread out. The hardware counters in
+PerfCounters.h are read around every trial where the system allows it, and
+the median of each one is reported with the IPC and misses per thousand
+instructions. Programs that route the global operator new and delete through
+heapAllocated and heapFreed also get the peak heap memory of every case.
+*/
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include "PerfCounters.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace std;
+
+// Heap bytes in use and their high-water mark, while heapTracked is set.
+inline atomic<bool> heapTracked(false);
+inline atomic<long long> heapBytes(0);
+inline atomic<long long> heapPeakBytes(0);
+
+/*
+Description: Records an allocation and raises the high-water mark. Meant to
+be called from a replacement for the global operator new.
+Parameters: Bytes allocated.
+Return: None
+*/
+inline void heapAllocated(size_t bytes) {
+  long long now = heapBytes += bytes;
+  long long peak = heapPeakBytes.load(memory_order_relaxed);
+  while (now > peak && !heapPeakBytes.compare_exchange_weak(peak, now))
+    ;
+}
+
+/*
+Description: Records a deallocation. Meant to be called from a replacement
+for the global operator delete.
+Parameters: Bytes freed.
+Return: None
+*/
+inline void heapFreed(size_t bytes) { heapBytes -= bytes; }
+
+struct BenchmarkOptions {
+  int warmups = 1;           // untimed trials before measuring
+  int minTrials = 5;         // trials before the interval is checked
+  int maxTrials = 50;        // trials after which a case stops regardless
+  double confidence = 0.02;  // target half-width of the 95% CI over the mean
+  double maxSeconds = 2.0;   // measuring time after which a case stops
+  int cpu = 0;               // CPU to pin to, or -1 to leave the mask alone
+  string filter;             // only cases whose name contains this are run
+};
+
+struct BenchmarkResult {
+  string name;
+  long long size;
+  size_t elementBytes;
+  int trials;
+  double median, p5, p95, mean, ciHalfWidth; // seconds
+  PerfSample counters;                       // median per trial, -1 if N/A
+  long long peakHeapBytes; // most heap a trial allocated, -1 if N/A
+
+  double nsPerElement() const { return size > 0 ? median * 1e9 / size : 0; }
+  double megabytesPerSecond() const {
+    return median > 0 ? size * elementBytes / median / 1e6 : 0;
+  }
+};
+
+class Benchmark {
+public:
+  explicit Benchmark(const BenchmarkOptions &options);
+  ~Benchmark();
+
+  bool pinned() const { return pinnedCPU >= 0; }
+  int cpu() const { return pinnedCPU; }
+
+  bool selected(const string &name) const {
+    return name.find(options.filter) != string::npos;
+  }
+
+  template <class Setup, class Run>
+  void measure(const string &name, long long size, size_t elementBytes,
+               Setup setup, Run run, int threads = 1);
+
+  const vector<BenchmarkResult> &results() const { return done; }
+  void writeCSV(ostream &out) const;
+  void writeJSON(ostream &out) const;
+
+private:
+  BenchmarkOptions options;
+  vector<BenchmarkResult> done;
+  int pinnedCPU;
+#ifdef __linux__
+  cpu_set_t originalMask;
+#endif
+
+  void setAffinity(bool wide);
+};
+
+/*
+Description: Two-sided 95% quantile of Student's t distribution.
+Parameters: Degrees of freedom.
+Return: The quantile, close enough for deciding when to stop sampling.
+*/
+inline double studentT95(int df) {
+  static const double table[] = {12.706, 4.303, 2.776, 2.571, 2.447, 2.365,
+                                 2.306,  2.262, 2.228, 2.201, 2.179, 2.160,
+                                 2.145,  2.131, 2.120, 2.110, 2.101, 2.093,
+                                 2.086,  2.080, 2.074, 2.069, 2.064, 2.060,
+                                 2.056,  2.052, 2.048, 2.045, 2.042, 2.042};
+  if (df < 1)
+    return table[0];
+  return df <= 30 ? table[df - 1] : 1.96;
+}
+
+/*
+Description: Field name for the misses per thousand instructions of an event.
+Parameters: One of the miss events, PERF_L1D_MISSES onward.
+Return: The name.
+*/
+inline const char *mpkiName(PerfEvent event) {
+  static const char *names[PERF_EVENT_COUNT] = {
+      "", "", "l1d_mpki", "llc_mpki", "branch_mpki", "dtlb_mpki"};
+  return names[event];
+}
+
+/*
+Description: Percentile of sorted samples, interpolating between neighbors.
+Parameters: Sorted samples and the fraction (0 to 1) to read.
+Return: The percentile, or 0 without samples.
+*/
+inline double percentile(const vector<double> &sorted, double fraction) {
+  if (sorted.empty())
+    return 0;
+  double position = fraction * (sorted.size() - 1);
+  size_t below = static_cast<size_t>(position);
+  size_t above = min(below + 1, sorted.size() - 1);
+  return sorted[below] + (sorted[above] - sorted[below]) * (position - below);
+}
+
+/*
+Description: Saves the CPU mask and pins the calling thread to the chosen
+CPU.
+Parameters: Harness options.
+Return: None
+Notes: If the CPU cannot be used the harness runs unpinned.
+*/
+inline Benchmark::Benchmark(const BenchmarkOptions &options)
+    : options(options), pinnedCPU(-1) {
+#ifdef __linux__
+  if (options.cpu >= 0 &&
+      sched_getaffinity(0, sizeof(originalMask), &originalMask) == 0 &&
+      CPU_ISSET(options.cpu, &originalMask)) {
+    pinnedCPU = options.cpu;
+    setAffinity(false);
+  }
+#endif
+}
+
+/*
+Description: Restores the CPU mask the harness started with.
+Parameters: None
+Return: None
+*/
+inline Benchmark::~Benchmark() {
+  if (pinned())
+    setAffinity(true);
+}
+
+/*
+Description: Switches the calling thread between the pinned CPU and the
+original mask. Threads started while the mask is wide inherit it.
+Parameters: Whether to restore the original mask.
+Return: None
+*/
+inline void Benchmark::setAffinity(bool wide) {
+#ifdef __linux__
+  if (!pinned())
+    return;
+  cpu_set_t mask;
+  if (wide) {
+    mask = originalMask;
+  } else {
+    CPU_ZERO(&mask);
+    CPU_SET(pinnedCPU, &mask);
+  }
+  sched_setaffinity(0, sizeof(mask), &mask);
+#else
+  (void)wide;
+#endif
+}
+
+/*
+Description: Times one case. Every trial first calls setup, untimed, to
+copy a fresh input, then times run. After the warmups, trials repeat until
+there are at least minTrials and the 95% confidence interval of the mean is
+within the target fraction of the mean, or until maxTrials or maxSeconds is
+reached.
+Parameters: Case name, number of elements, bytes per element, setup and
+run callables, and the number of threads the case uses.
+Return: None
+Notes: Cases left out by the filter are skipped. The summary is kept for
+results(), writeCSV and writeJSON. The peak heap of a case is the most any
+one trial's run allocated on top of what was in use when it started.
+*/
+template <class Setup, class Run>
+void Benchmark::measure(const string &name, long long size,
+                        size_t elementBytes, Setup setup, Run run,
+                        int threads) {
+  if (!selected(name))
+    return;
+  if (threads > 1)
+    setAffinity(true);
+
+  for (int w = 0; w < options.warmups; w++) {
+    setup();
+    run();
+  }
+
+  PerfCounterGroup counters;
+  vector<double> seconds;
+  vector<PerfSample> samples;
+  long long peakHeap = 0;
+  double total = 0, totalSquares = 0, halfWidth = 0;
+  while (static_cast<int>(seconds.size()) < max(options.maxTrials, 1)) {
+    setup();
+    long long heapBase = heapBytes;
+    heapPeakBytes = heapBase;
+    counters.start();
+    auto start = chrono::steady_clock::now();
+    run();
+    auto end = chrono::steady_clock::now();
+    PerfSample sample = counters.stop();
+    peakHeap = max(peakHeap, heapPeakBytes - heapBase);
+    samples.push_back(sample);
+
+    double s = chrono::duration<double>(end - start).count();
+    seconds.push_back(s);
+    total += s;
+    totalSquares += s * s;
+
+    int n = seconds.size();
+    double mean = total / n;
+    double variance =
+        n > 1 ? max(0.0, (totalSquares - n * mean * mean) / (n - 1)) : 0;
+    halfWidth = studentT95(n - 1) * sqrt(variance / n);
+    if (n >= options.minTrials &&
+        (halfWidth <= options.confidence * mean || total >= options.maxSeconds))
+      break;
+  }
+
+  if (threads > 1)
+    setAffinity(false);
+
+  BenchmarkResult result;
+  result.name = name;
+  result.size = size;
+  result.elementBytes = elementBytes;
+  result.trials = seconds.size();
+  result.mean = total / seconds.size();
+  result.ciHalfWidth = halfWidth;
+  result.peakHeapBytes = heapTracked ? peakHeap : -1;
+  std::sort(seconds.begin(), seconds.end());
+  result.median = percentile(seconds, 0.5);
+  result.p5 = percentile(seconds, 0.05);
+  result.p95 = percentile(seconds, 0.95);
+  for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+    vector<long long> counts;
+    for (const PerfSample &sample : samples)
+      counts.push_back(sample.counts[e]);
+    std::sort(counts.begin(), counts.end());
+    result.counters.counts[e] = counts[counts.size() / 2];
+  }
+  done.push_back(result);
+}
+
+/*
+Description: Writes one CSV row per measured case, with a header row.
+Parameters: Output stream.
+Return: None
+Notes: Times are in seconds; unavailable counters and untracked peak heap
+are left empty.
+*/
+inline void Benchmark::writeCSV(ostream &out) const {
+  out << "name,size,trials,median_s,p5_s,p95_s,mean_s,ci95_s,"
+         "ns_per_element,mb_per_s";
+  for (int e = 0; e < PERF_EVENT_COUNT; e++)
+    out << ',' << perfEventName(static_cast<PerfEvent>(e));
+  out << ",ipc";
+  for (int e = PERF_L1D_MISSES; e < PERF_EVENT_COUNT; e++)
+    out << ',' << mpkiName(static_cast<PerfEvent>(e));
+  out << ",peak_heap_bytes\n";
+  for (const BenchmarkResult &r : done) {
+    out << '"' << r.name << "\"," << r.size << ',' << r.trials << ','
+        << r.median << ',' << r.p5 << ',' << r.p95 << ',' << r.mean << ','
+        << r.ciHalfWidth << ',' << r.nsPerElement() << ','
+        << r.megabytesPerSecond();
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+      out << ',';
+      if (r.counters.has(static_cast<PerfEvent>(e)))
+        out << r.counters.counts[e];
+    }
+    out << ',';
+    if (r.counters.ipc() >= 0)
+      out << r.counters.ipc();
+    for (int e = PERF_L1D_MISSES; e < PERF_EVENT_COUNT; e++) {
+      double rate = r.counters.perKiloInstruction(static_cast<PerfEvent>(e));
+      out << ',';
+      if (rate >= 0)
+        out << rate;
+    }
+    out << ',';
+    if (r.peakHeapBytes >= 0)
+      out << r.peakHeapBytes;
+    out << '\n';
+  }
+}
+
+/*
+Description: Writes the harness settings and every measured case as JSON.
+Parameters: Output stream.
+Return: None
+Notes: Case names are written as they are, so they must not contain quotes
+or backslashes.
+*/
+inline void Benchmark::writeJSON(ostream &out) const {
+  out << "{\n  \"cpu\": " << pinnedCPU << ",\n  \"warmups\": "
+      << options.warmups << ",\n  \"confidence\": " << options.confidence
+      << ",\n  \"results\": [";
+  for (size_t i = 0; i < done.size(); i++) {
+    const BenchmarkResult &r = done[i];
+    out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name
+        << "\", \"size\": " << r.size << ", \"trials\": " << r.trials
+        << ", \"median_s\": " << r.median << ", \"p5_s\": " << r.p5
+        << ", \"p95_s\": " << r.p95 << ", \"mean_s\": " << r.mean
+        << ", \"ci95_s\": " << r.ciHalfWidth
+        << ", \"ns_per_element\": " << r.nsPerElement()
+        << ", \"mb_per_s\": " << r.megabytesPerSecond();
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+      out << ", \"" << perfEventName(static_cast<PerfEvent>(e)) << "\": ";
+      if (r.counters.has(static_cast<PerfEvent>(e)))
+        out << r.counters.counts[e];
+      else
+        out << "null";
+    }
+    out << ", \"ipc\": ";
+    if (r.counters.ipc() >= 0)
+      out << r.counters.ipc();
+    else
+      out << "null";
+    for (int e = PERF_L1D_MISSES; e < PERF_EVENT_COUNT; e++) {
+      double rate = r.counters.perKiloInstruction(static_cast<PerfEvent>(e));
+      out << ", \"" << mpkiName(static_cast<PerfEvent>(e)) << "\": ";
+      if (rate >= 0)
+        out << rate;
+      else
+        out << "null";
+    }
+    out << ", \"peak_heap_bytes\": ";
+    if (r.peakHeapBytes >= 0)
+      out << r.peakHeapBytes;
+    else
+      out << "null";
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+#endif /* BENCHMARK_H_ */
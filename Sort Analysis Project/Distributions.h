@@ -0,0 +1,350 @@
+/*
+Author: JJ McCauley
+Creation Date: 10/17/26
+Last Update: 10/17/26
+Description: Input generators for the sorting benchmarks. Arrays of 32 or
+64-bit integers, floats, doubles or strings are filled from one of several
+distributions with a seeded xoshiro256** generator, so every run of a
+benchmark sees the same inputs for the same seed.
+Notes: Large arrays are generated in blocks of GENERATE_BLOCK entries, each
+with its own generator derived from the seed and the block number, so the
+blocks can be filled in parallel and the output does not depend on the
+number of threads.
+*/
+
+#ifndef DISTRIBUTIONS_H_
+#define DISTRIBUTIONS_H_
+
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+using namespace std;
+
+// Entries generated by one task, and by one generator stream.
+const long long GENERATE_BLOCK = 1 << 16;
+// Distinct keys in DIST_FEW_UNIQUE.
+const int FEW_UNIQUE_KEYS = 16;
+// Number of ascending teeth in DIST_SAWTOOTH.
+const int SAWTOOTH_TEETH = 16;
+// Every entry of DIST_K_SORTED is within this distance of its sorted place.
+const int K_SORTED_WINDOW = 16;
+// Percent of DIST_SORTED_APPENDS that is random entries after a sorted run.
+const int APPENDED_PERCENT = 5;
+// Exponent of DIST_ZIPF; 1 is the classic word-frequency law.
+const double ZIPF_EXPONENT = 1.0;
+
+enum Distribution {
+  DIST_UNIFORM,
+  DIST_SORTED,
+  DIST_REVERSED,
+  DIST_SAWTOOTH,
+  DIST_ORGAN_PIPE,
+  DIST_FEW_UNIQUE,
+  DIST_ZIPF,
+  DIST_GAUSSIAN,
+  DIST_K_SORTED,
+  DIST_ALL_EQUAL,
+  DIST_SORTED_APPENDS,
+  DIST_COUNT
+};
+
+/*
+Description: Name of a distribution, used in benchmark case names.
+Parameters: Distribution.
+Return: The name.
+*/
+inline const char *distributionName(Distribution d) {
+  static const char *names[DIST_COUNT] = {
+      "Uniform",  "Sorted",   "Reversed",    "Sawtooth",
+      "Organ Pipe", "Few Unique", "Zipf",    "Gaussian",
+      "k-Sorted", "All Equal", "Sorted + Appends"};
+  return names[d];
+}
+
+/*
+Description: SplitMix64 step, used to seed xoshiro and to derive the seed of
+every block.
+Parameters: State, which is advanced.
+Return: The next 64 random bits.
+*/
+inline uint64_t splitMix64(uint64_t &state) {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/*
+Description: xoshiro256** generator (Blackman and Vigna). It also meets the
+standard UniformRandomBitGenerator requirements, so it can drive the
+<random> distributions.
+*/
+class Xoshiro256 {
+public:
+  typedef uint64_t result_type;
+
+  explicit Xoshiro256(uint64_t seed, uint64_t stream = 0) {
+    uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    for (int i = 0; i < 4; i++)
+      s[i] = splitMix64(state);
+  }
+
+  static constexpr uint64_t min() { return 0; }
+  static constexpr uint64_t max() { return ~uint64_t(0); }
+
+  uint64_t operator()() {
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+  }
+
+  // Uniform in [0, bound), by Lemire's multiply and reject.
+  uint64_t below(uint64_t bound) {
+    unsigned __int128 m = static_cast<unsigned __int128>((*this)()) * bound;
+    uint64_t low = static_cast<uint64_t>(m);
+    if (low < bound) {
+      uint64_t threshold = -bound % bound;
+      while (low < threshold) {
+        m = static_cast<unsigned __int128>((*this)()) * bound;
+        low = static_cast<uint64_t>(m);
+      }
+    }
+    return static_cast<uint64_t>(m >> 64);
+  }
+
+  // Uniform in [0, 1) with 53 random bits.
+  double uniform() { return ((*this)() >> 11) * 0x1.0p-53; }
+
+  // Standard normal, by the Box-Muller transform.
+  double gaussian() {
+    double u = 1.0 - uniform();
+    return sqrt(-2.0 * log(u)) * cos(6.283185307179586 * uniform());
+  }
+
+private:
+  uint64_t s[4];
+
+  static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+/*
+Description: Zipf distribution over the ranks 1 .. n by rejection-inversion
+(Hormann and Derflinger), which takes constant expected time per sample and
+no table, so n can be as large as the array.
+*/
+class ZipfSampler {
+public:
+  ZipfSampler(long long n, double exponent)
+      : n(max(n, 1LL)), s(exponent) {
+    hIntegralX1 = hIntegral(1.5) - 1.0;
+    hIntegralN = hIntegral(this->n + 0.5);
+    threshold = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+  }
+
+  long long operator()(Xoshiro256 &generator) const {
+    while (true) {
+      double u = hIntegralN + generator.uniform() * (hIntegralX1 - hIntegralN);
+      double x = hIntegralInverse(u);
+      long long k = static_cast<long long>(x + 0.5);
+      k = min(max(k, 1LL), n);
+      if (k - x <= threshold || u >= hIntegral(k + 0.5) - h(k))
+        return k;
+    }
+  }
+
+private:
+  long long n;
+  double s, hIntegralX1, hIntegralN, threshold;
+
+  double h(double x) const { return exp(-s * log(x)); }
+
+  double hIntegral(double x) const {
+    double logX = log(x);
+    return expm1Ratio((1.0 - s) * logX) * logX;
+  }
+
+  double hIntegralInverse(double x) const {
+    double t = max(x * (1.0 - s), -1.0);
+    return exp(log1pRatio(t) * x);
+  }
+
+  // log(1 + x) / x and (exp(x) - 1) / x, accurate near 0.
+  static double log1pRatio(double x) {
+    if (fabs(x) > 1e-8)
+      return log1p(x) / x;
+    return 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+  }
+
+  static double expm1Ratio(double x) {
+    if (fabs(x) > 1e-8)
+      return expm1(x) / x;
+    return 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+  }
+};
+
+/*
+Description: Runs f(first, last, generator) over the blocks of [0, n), on
+the given number of threads, with every block's generator derived from the
+seed and the block number.
+Parameters: Number of entries, seed, number of threads and the block
+function.
+Return: None
+*/
+template <class F>
+void generateBlocks(long long n, uint64_t seed, int threads, F f) {
+  long long blocks = (n + GENERATE_BLOCK - 1) / GENERATE_BLOCK;
+  auto runBlock = [&](long long b) {
+    Xoshiro256 generator(seed, b + 1);
+    f(b * GENERATE_BLOCK, min(n, (b + 1) * GENERATE_BLOCK), generator);
+  };
+
+  if (threads <= 1 || blocks <= 1) {
+    for (long long b = 0; b < blocks; b++)
+      runBlock(b);
+    return;
+  }
+
+  WorkStealingPool pool(threads);
+  TaskGroup group(pool);
+  for (int t = 0; t < threads; t++)
+    group.run([&, t]() {
+      for (long long b = t; b < blocks; b += threads)
+        runBlock(b);
+    });
+  group.wait();
+}
+
+/*
+Description: Fills an array from a distribution. Structured distributions
+use the positions as keys: sorted is 0 .. n - 1, reversed counts down from
+n, sawtooth repeats SAWTOOTH_TEETH ascending runs, and organ pipe rises to
+the middle and falls again. Few unique draws from FEW_UNIQUE_KEYS keys, Zipf
+draws ranks 1 .. n with ZIPF_EXPONENT, k-sorted shuffles sorted windows of
+K_SORTED_WINDOW entries, and sorted + appends is sorted except for a random
+last APPENDED_PERCENT percent, like a sorted log with new entries appended.
+Parameters: Array A, number of entries, distribution, seed and the number of
+threads to use.
+Return: None
+Notes: T is an integer or floating point type. Uniform integers are
+non-negative, uniform floats are in [0, 1), and Gaussian keys are standard
+normal for floats and scaled by n / 8 and rounded for integers, so they are
+the only negative keys.
+*/
+template <class T>
+void generate(T A[], long long n, Distribution d, uint64_t seed,
+              int threads = 1) {
+  static_assert(is_arithmetic<T>::value, "generate needs arithmetic keys");
+  const bool real = is_floating_point<T>::value;
+  const int mantissa = numeric_limits<T>::digits; // uniform reals are exact
+  ZipfSampler zipf(n, ZIPF_EXPONENT);
+  long long sortedPrefix = n - n * APPENDED_PERCENT / 100;
+  long long tooth = max(1LL, (n + SAWTOOTH_TEETH - 1) / SAWTOOTH_TEETH);
+
+  generateBlocks(n, seed, threads, [&](long long first, long long last,
+                                       Xoshiro256 &generator) {
+    for (long long i = first; i < last; i++) {
+      switch (d) {
+      case DIST_UNIFORM:
+        if (real)
+          A[i] = ldexp(static_cast<T>(generator() >> (64 - mantissa)),
+                       -mantissa);
+        else
+          A[i] = static_cast<T>(generator() >> (64 - 8 * sizeof(T) +
+                                                is_signed<T>::value));
+        break;
+      case DIST_SORTED:
+      case DIST_K_SORTED:
+        A[i] = static_cast<T>(i);
+        break;
+      case DIST_REVERSED:
+        A[i] = static_cast<T>(n - i);
+        break;
+      case DIST_SAWTOOTH:
+        A[i] = static_cast<T>(i % tooth);
+        break;
+      case DIST_ORGAN_PIPE:
+        A[i] = static_cast<T>(min(i, n - 1 - i));
+        break;
+      case DIST_FEW_UNIQUE:
+        A[i] = static_cast<T>(generator.below(FEW_UNIQUE_KEYS));
+        break;
+      case DIST_ZIPF:
+        A[i] = static_cast<T>(zipf(generator));
+        break;
+      case DIST_GAUSSIAN:
+        if (real)
+          A[i] = static_cast<T>(generator.gaussian());
+        else
+          A[i] = static_cast<T>(llround(generator.gaussian() * (n / 8.0)));
+        break;
+      case DIST_ALL_EQUAL:
+        A[i] = static_cast<T>(1);
+        break;
+      case DIST_SORTED_APPENDS:
+        if (i < sortedPrefix)
+          A[i] = static_cast<T>(i);
+        else
+          A[i] = static_cast<T>(generator.below(n));
+        break;
+      default:
+        A[i] = T();
+      }
+    }
+
+    // Blocks are a multiple of the window, so windows never cross tasks
+    if (d == DIST_K_SORTED)
+      for (long long start = first; start < last; start += K_SORTED_WINDOW) {
+        long long window = min<long long>(K_SORTED_WINDOW, last - start);
+        for (long long i = window - 1; i > 0; i--)
+          swap(A[start + i], A[start + generator.below(i + 1)]);
+      }
+  });
+}
+
+// Letters in the body of a generated string key, enough for 64 bits.
+const int STRING_KEY_LETTERS = 14;
+// Prefix shared by every generated string key, as in paths or URLs.
+const char STRING_KEY_PREFIX[] = "key/";
+
+/*
+Description: Fills an array of strings from a distribution. The keys are
+generated as 64-bit integers and written as STRING_KEY_PREFIX followed by a
+fixed width base 26 number, so the strings sort in the same order as the
+integers they came from.
+Parameters: Array A, number of entries, distribution, seed and the number of
+threads to use.
+Return: None
+*/
+inline void generateStrings(string A[], long long n, Distribution d,
+                            uint64_t seed, int threads = 1) {
+  long long *keys = new long long[n];
+  generate(keys, n, d, seed, threads);
+
+  generateBlocks(n, seed, threads,
+                 [&](long long first, long long last, Xoshiro256 &) {
+    const size_t prefix = sizeof(STRING_KEY_PREFIX) - 1;
+    for (long long i = first; i < last; i++) {
+      uint64_t key = static_cast<uint64_t>(keys[i]) ^ (uint64_t(1) << 63);
+      A[i].assign(STRING_KEY_PREFIX);
+      A[i].resize(prefix + STRING_KEY_LETTERS);
+      for (int c = STRING_KEY_LETTERS - 1; c >= 0; c--) {
+        A[i][prefix + c] = static_cast<char>('a' + key % 26);
+        key /= 26;
+      }
+    }
+  });
+  delete[] keys;
+}
+
+#endif /* DISTRIBUTIONS_H_ */
@@ -0,0 +1,84 @@
+/*Author: JJ McCauley
+Creation Date: 10/17/26
+Last Update: 10/17/26
+Description: This program sorts a binary file of fixed-size records that may be larger
+than the available memory, using the external merge sort in "ExternalSort.h". Every
+record holds an unsigned little-endian key of 1 to 8 bytes at a fixed offset.
+User Interface: extsort <input> <output> <record size> <key offset> <memory MB>
+[key size = 8] [threads = number of cores] [temp directory = .]
+Notes: The time taken by the sort is printed when it finishes */
+
+//External merge sort and the record format
+#include "ExternalSort.h"
+//Allows communication via the standard output
+#include <iostream>
+//Parsing the command line arguments
+#include <cstdlib>
+//Timing with Chrono
+#include <chrono>
+
+using namespace std;
+
+/* Function Prototypes */
+//Print how the program is used
+void printUsage();
+//Convert an argument to a positive number, returning -1 when it is not one
+long long parseArgument(const char *);
+
+int main(int argc, char *argv[]) {
+    if(argc < 6 || argc > 9) {
+        printUsage();
+        return 1;
+    }
+
+    long long recordSize = parseArgument(argv[3]);
+    long long keyOffset = parseArgument(argv[4]);
+    long long memoryMB = parseArgument(argv[5]);
+    long long keySize = argc > 6 ? parseArgument(argv[6]) : 8;
+    long long threads = argc > 7 ? parseArgument(argv[7]) : max(1u, thread::hardware_concurrency());
+    string tempDir = argc > 8 ? argv[8] : ".";
+    if(recordSize <= 0 || keyOffset < 0 || memoryMB <= 0 || keySize <= 0 || threads <= 0) {
+        printUsage();
+        return 1;
+    }
+
+    RecordFormat format;
+    format.recordSize = recordSize;
+    format.keyOffset = keyOffset;
+    format.keySize = keySize;
+
+    auto start = chrono::high_resolution_clock::now();
+    try {
+        externalSort(argv[1], argv[2], format, memoryMB << 20, tempDir, threads);
+    }
+    catch(const exception &e) {
+        cout << "Error - " << e.what() << endl;
+        return 1;
+    }
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+    cout << "Sorted " << argv[1] << " into " << argv[2] << " in " << elapsed.count() << " seconds" << endl;
+    return 0;
+}
+
+/*Description: This function prints the command line arguments the program expects.
+Parameters: N/A
+Return: N/A
+Notes: N/A */
+void printUsage() {
+    cout << "Usage: extsort <input> <output> <record size> <key offset> <memory MB>"
+         << " [key size] [threads] [temp directory]" << endl;
+    cout << "Keys are unsigned little-endian integers of 1 to 8 bytes (8 by default)." << endl;
+}
+
+/*Description: This function converts a command line argument to a number.
+Parameters: const char *arg: The argument to be converted
+Return: long long: The number, or -1 if the argument is not a non-negative number
+Notes: N/A */
+long long parseArgument(const char *arg) {
+    char *end;
+    long long value = strtoll(arg, &end, 10);
+    if(*arg == '\0' || *end != '\0' || value < 0) {
+        return -1;
+    }
+    return value;
+}
@@ -0,0 +1,440 @@
+/*
+Author: JJ McCauley
+Creation Date: 10/17/26
+Last Update: 10/17/26
+Description: External (out-of-core) merge sort for binary files of fixed-size
+records that are larger than the memory budget.
+Notes: Keys are unsigned little-endian integers of 1 to 8 bytes stored at a
+fixed offset inside every record. The sort runs in two stages:
+  1. Run formation: the input is read in chunks that fit half the budget.
+     Each chunk's keys are sorted in memory and the chunk is written out as
+     a sorted run by a background thread while the next chunk is read and
+     sorted (double buffering).
+  2. Merging: up to the fan-in the budget allows, runs are merged with a
+     loser tree. Every run reader keeps two blocks and reads the next one in
+     the background while the current one is consumed, and the output is
+     written the same way. More runs than the fan-in take extra passes.
+Records with equal keys keep their input order. Errors throw runtime_error.
+*/
+
+#ifndef EXTERNALSORT_H_
+#define EXTERNALSORT_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Sorts.h"
+
+using namespace std;
+
+// Smallest block a run reader or writer works with during the merge.
+const size_t EXTERNAL_MIN_BLOCK = 1 << 16;
+// Largest block worth reading at once; bigger budgets raise the fan-in instead.
+const size_t EXTERNAL_MAX_BLOCK = 1 << 23;
+
+/*
+Description: Layout of the records being sorted.
+*/
+struct RecordFormat {
+  size_t recordSize;
+  size_t keyOffset;
+  size_t keySize;
+
+  uint64_t key(const char *record) const {
+    uint64_t k = 0;
+    for (size_t b = keySize; b > 0; b--)
+      k = (k << 8) | static_cast<unsigned char>(record[keyOffset + b - 1]);
+    return k;
+  }
+};
+
+/*
+Description: Key of a record in a chunk along with the record's position.
+Comparing positions after keys makes the in-memory sort stable.
+*/
+struct ExternalKey {
+  uint64_t key;
+  long long index;
+
+  bool operator<(const ExternalKey &o) const {
+    return key < o.key || (key == o.key && index < o.index);
+  }
+  bool operator>(const ExternalKey &o) const { return o < *this; }
+};
+
+/*
+Description: Opens a file, throwing when it cannot be opened.
+Parameters: File name and fopen mode.
+Return: The open file.
+*/
+inline FILE *openExternalFile(const string &name, const char *mode) {
+  FILE *file = fopen(name.c_str(), mode);
+  if (file == nullptr)
+    throw runtime_error("could not open " + name);
+  return file;
+}
+
+/*
+Description: Writes a block, throwing on a short write.
+Parameters: File, data and number of bytes.
+Return: None
+*/
+inline void writeBlock(FILE *file, const char *data, size_t bytes) {
+  if (fwrite(data, 1, bytes, file) != bytes)
+    throw runtime_error("write failed");
+}
+
+/*
+Description: Reads up to the given number of whole records.
+Parameters: File, buffer, maximum number of records and record size.
+Return: Number of records read, 0 at the end of the file.
+Notes: Throws if the file ends partway through a record.
+*/
+inline size_t readRecords(FILE *file, char *buffer, size_t maxRecords,
+                          size_t recordSize) {
+  size_t bytes = fread(buffer, 1, maxRecords * recordSize, file);
+  if (ferror(file))
+    throw runtime_error("read failed");
+  if (bytes % recordSize != 0)
+    throw runtime_error("file size is not a multiple of the record size");
+  return bytes / recordSize;
+}
+
+/*
+Description: Sequential reader for one run with a block of read-ahead. While
+the records of one block are handed out, the next block is read by a
+background task into the other buffer.
+*/
+class RunReader {
+public:
+  RunReader(const string &name, size_t recordSize, size_t blockRecords);
+  ~RunReader();
+
+  bool done() const { return position == filled; }
+  const char *current() const { return &buffers[active][position]; }
+  void advance();
+
+private:
+  FILE *file;
+  size_t recordSize;
+  size_t blockRecords;
+  vector<char> buffers[2];
+  int active;
+  size_t position; // byte offsets into the active buffer
+  size_t filled;
+  future<size_t> pending;
+
+  void prefetch(int buffer);
+};
+
+inline RunReader::RunReader(const string &name, size_t recordSize,
+                            size_t blockRecords)
+    : file(openExternalFile(name, "rb")), recordSize(recordSize),
+      blockRecords(blockRecords), active(0), position(0) {
+  buffers[0].resize(blockRecords * recordSize);
+  buffers[1].resize(blockRecords * recordSize);
+  filled = readRecords(file, buffers[0].data(), blockRecords, recordSize) *
+           recordSize;
+  prefetch(1);
+}
+
+inline RunReader::~RunReader() {
+  if (pending.valid())
+    pending.wait();
+  fclose(file);
+}
+
+/*
+Description: Starts reading the next block into a buffer in the background.
+Parameters: Buffer to fill.
+Return: None
+*/
+inline void RunReader::prefetch(int buffer) {
+  char *data = buffers[buffer].data();
+  pending = async(launch::async, [this, data]() {
+    return readRecords(file, data, blockRecords, recordSize);
+  });
+}
+
+/*
+Description: Moves to the next record, switching to the prefetched block
+when the active one is used up.
+Parameters: None
+Return: None
+*/
+inline void RunReader::advance() {
+  position += recordSize;
+  if (position < filled)
+    return;
+
+  size_t records = pending.get();
+  active = 1 - active;
+  position = 0;
+  filled = records * recordSize;
+  if (records > 0)
+    prefetch(1 - active);
+}
+
+/*
+Description: Sequential writer with double buffering. A full block is handed
+to a background task while records are copied into the other block.
+*/
+class BlockWriter {
+public:
+  BlockWriter(const string &name, size_t blockBytes);
+  ~BlockWriter();
+
+  void write(const char *record, size_t bytes);
+  void close();
+
+private:
+  FILE *file;
+  vector<char> buffers[2];
+  int active;
+  size_t used;
+  future<void> pending;
+
+  void flush();
+};
+
+inline BlockWriter::BlockWriter(const string &name, size_t blockBytes)
+    : file(openExternalFile(name, "wb")), active(0), used(0) {
+  buffers[0].resize(blockBytes);
+  buffers[1].resize(blockBytes);
+}
+
+inline BlockWriter::~BlockWriter() {
+  if (pending.valid())
+    pending.wait();
+  if (file != nullptr)
+    fclose(file);
+}
+
+/*
+Description: Hands the active block to the background writer and switches
+to the other block once its previous write has finished.
+Parameters: None
+Return: None
+*/
+inline void BlockWriter::flush() {
+  if (pending.valid())
+    pending.get();
+
+  const char *data = buffers[active].data();
+  size_t bytes = used;
+  FILE *out = file;
+  pending = async(launch::async, [out, data, bytes]() {
+    writeBlock(out, data, bytes);
+  });
+  active = 1 - active;
+  used = 0;
+}
+
+inline void BlockWriter::write(const char *record, size_t bytes) {
+  if (used + bytes > buffers[active].size())
+    flush();
+  copy(record, record + bytes, buffers[active].data() + used);
+  used += bytes;
+}
+
+/*
+Description: Writes what is left and closes the file.
+Parameters: None
+Return: None
+*/
+inline void BlockWriter::close() {
+  if (used > 0)
+    flush();
+  if (pending.valid())
+    pending.get();
+  if (fclose(file) != 0) {
+    file = nullptr;
+    throw runtime_error("write failed");
+  }
+  file = nullptr;
+}
+
+/*
+Description: Chunk of the input being sorted in memory: the raw records and
+their keys in sorted order.
+*/
+struct ExternalChunk {
+  vector<char> records;
+  vector<ExternalKey> keys;
+  size_t count;
+};
+
+/*
+Description: Writes a sorted chunk out as a run, gathering the records in
+key order through the stdio buffer.
+Parameters: Chunk, run file name and record format.
+Return: None
+*/
+inline void writeRun(const ExternalChunk &chunk, const string &name,
+                     const RecordFormat &format) {
+  FILE *file = openExternalFile(name, "wb");
+  setvbuf(file, nullptr, _IOFBF, EXTERNAL_MIN_BLOCK);
+  for (size_t i = 0; i < chunk.count; i++)
+    writeBlock(file,
+               chunk.records.data() + chunk.keys[i].index * format.recordSize,
+               format.recordSize);
+  if (fclose(file) != 0)
+    throw runtime_error("write failed");
+}
+
+/*
+Description: Run formation stage. Reads the input in chunks that use half of
+the memory budget each, sorts every chunk's keys with the parallel sample
+sort, and writes the chunk as a run on a background thread while the next
+chunk is read into the other half.
+Parameters: Input file, record format, memory budget in bytes, directory for
+the runs and the number of threads for the in-memory sort.
+Return: Names of the runs in input order.
+*/
+inline vector<string> createRuns(const string &input,
+                                 const RecordFormat &format,
+                                 size_t memoryBudget, const string &tempDir,
+                                 int threads) {
+  size_t chunkRecords =
+      memoryBudget / (2 * (format.recordSize + sizeof(ExternalKey)));
+  chunkRecords = min(max(chunkRecords, size_t(1)), size_t(1) << 30);
+
+  ExternalChunk chunks[2];
+  for (int c = 0; c < 2; c++) {
+    chunks[c].records.resize(chunkRecords * format.recordSize);
+    chunks[c].keys.resize(chunkRecords);
+  }
+
+  FILE *file = openExternalFile(input, "rb");
+  vector<string> runs;
+  future<void> pending[2];
+  int c = 0;
+
+  try {
+    while (true) {
+      ExternalChunk &chunk = chunks[c];
+      if (pending[c].valid())
+        pending[c].get();
+
+      chunk.count = readRecords(file, chunk.records.data(), chunkRecords,
+                                format.recordSize);
+      if (chunk.count == 0)
+        break;
+
+      for (size_t i = 0; i < chunk.count; i++) {
+        chunk.keys[i].key =
+            format.key(chunk.records.data() + i * format.recordSize);
+        chunk.keys[i].index = i;
+      }
+      sampleSort(chunk.keys.data(), static_cast<int>(chunk.count), threads);
+
+      string name = tempDir + "/extsort-run-0-" + to_string(runs.size());
+      runs.push_back(name);
+      pending[c] = async(launch::async, [&chunk, name, &format]() {
+        writeRun(chunk, name, format);
+      });
+      c = 1 - c;
+    }
+    if (pending[1 - c].valid())
+      pending[1 - c].get();
+  } catch (...) {
+    for (int i = 0; i < 2; i++)
+      if (pending[i].valid())
+        pending[i].wait();
+    fclose(file);
+    throw;
+  }
+
+  fclose(file);
+  return runs;
+}
+
+/*
+Description: Merges sorted runs into one file with a loser tree keyed on the
+record keys. Ties go to the earlier run, so the merge is stable.
+Parameters: Runs in input order, output file, record format and memory
+budget in bytes.
+Return: None
+*/
+inline void mergeExternalRuns(const vector<string> &runs, const string &output,
+                              const RecordFormat &format, size_t memoryBudget) {
+  int k = runs.size();
+  size_t blockBytes = memoryBudget / (2 * (k + 1));
+  blockBytes = min(max(blockBytes, EXTERNAL_MIN_BLOCK), EXTERNAL_MAX_BLOCK);
+  size_t blockRecords = max(blockBytes / format.recordSize, size_t(1));
+
+  vector<unique_ptr<RunReader>> readers;
+  LoserTree<uint64_t> tree(k);
+  for (int r = 0; r < k; r++) {
+    readers.push_back(unique_ptr<RunReader>(
+        new RunReader(runs[r], format.recordSize, blockRecords)));
+    if (!readers[r]->done())
+      tree.set(r, format.key(readers[r]->current()));
+  }
+  tree.build();
+
+  BlockWriter writer(output, blockRecords * format.recordSize);
+  while (!tree.empty()) {
+    RunReader &reader = *readers[tree.winner()];
+    writer.write(reader.current(), format.recordSize);
+    reader.advance();
+    if (reader.done())
+      tree.closeWinner();
+    else
+      tree.replaceWinner(format.key(reader.current()));
+  }
+  writer.close();
+}
+
+/*
+Description: Sorts a file of fixed-size records that may be larger than
+memory.
+Parameters: Input and output file names, record format, memory budget in
+bytes, directory for temporary runs and number of threads for sorting the
+chunks in memory.
+Return: None
+Notes: The fan-in of a merge pass is capped so that every run still gets
+two blocks of at least EXTERNAL_MIN_BLOCK bytes; more runs are merged in
+groups over several passes. The temporary runs are removed once merged.
+*/
+inline void externalSort(const string &input, const string &output,
+                         const RecordFormat &format, size_t memoryBudget,
+                         const string &tempDir = ".", int threads = 1) {
+  if (format.recordSize == 0 || format.keySize < 1 || format.keySize > 8 ||
+      format.keyOffset + format.keySize > format.recordSize)
+    throw runtime_error("the key does not fit in the record");
+
+  vector<string> runs =
+      createRuns(input, format, memoryBudget, tempDir, threads);
+
+  size_t minBlock = max(EXTERNAL_MIN_BLOCK, format.recordSize);
+  size_t blocks = memoryBudget / (2 * minBlock);
+  int maxFanIn =
+      static_cast<int>(min(max(blocks, size_t(3)) - 1, size_t(1) << 20));
+
+  for (int pass = 1; static_cast<int>(runs.size()) > maxFanIn; pass++) {
+    vector<string> merged;
+    for (size_t first = 0; first < runs.size(); first += maxFanIn) {
+      size_t last = min(runs.size(), first + maxFanIn);
+      vector<string> group(runs.begin() + first, runs.begin() + last);
+      string name = tempDir + "/extsort-run-" + to_string(pass) + "-" +
+                    to_string(merged.size());
+      mergeExternalRuns(group, name, format, memoryBudget);
+      for (size_t r = 0; r < group.size(); r++)
+        remove(group[r].c_str());
+      merged.push_back(name);
+    }
+    runs = merged;
+  }
+
+  mergeExternalRuns(runs, output, format, memoryBudget);
+  for (size_t r = 0; r < runs.size(); r++)
+    remove(runs[r].c_str());
+}
+
+#endif /* EXTERNALSORT_H_ */
@@ -0,0 +1,298 @@
+/*
+Author: JJ McCauley
+Creation Date: 10/17/26
+Last Update: 10/17/26
+Description: Hardware performance counter wrapper used by the timing programs.
+A PerfCounterGroup is wrapped around a timed region and reads the cycles,
+instructions, L1 data cache misses, last level cache misses, branch misses
+and data TLB misses of that region.
+Notes: Counters are opened with the Linux perf_event_open system call and only
+count user-space events of the calling thread and the threads it starts. On
+other systems, or when the kernel refuses a counter (for example because of
+perf_event_paranoid, a virtual machine without a PMU or a container without
+perf access), that counter is unavailable and reads as -1, so callers can
+print N/A and carry on; the other counters still work. When more events are
+requested than the CPU has counters, the kernel time-shares them and the
+counts are scaled up to the whole region.
+*/
+
+#ifndef PERFCOUNTERS_H_
+#define PERFCOUNTERS_H_
+
+#include <ostream>
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum PerfEvent {
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_L1D_MISSES,
+  PERF_LLC_MISSES,
+  PERF_BRANCH_MISSES,
+  PERF_DTLB_MISSES,
+  PERF_EVENT_COUNT
+};
+
+/*
+Description: Short name of an event, used for CSV and JSON fields.
+Parameters: Event.
+Return: The name.
+*/
+inline const char *perfEventName(PerfEvent event) {
+  static const char *names[PERF_EVENT_COUNT] = {
+      "cycles",        "instructions", "l1d_misses",
+      "llc_misses",    "branch_misses", "dtlb_misses"};
+  return names[event];
+}
+
+class PerfCounter {
+public:
+  explicit PerfCounter(PerfEvent event);
+  ~PerfCounter();
+
+  bool available() const { return fd >= 0; }
+  void start();
+  long long stop();
+
+private:
+  int fd;
+
+  PerfCounter(const PerfCounter &);
+  PerfCounter &operator=(const PerfCounter &);
+};
+
+/*
+Description: Counts read from a PerfCounterGroup, -1 where unavailable.
+*/
+struct PerfSample {
+  long long counts[PERF_EVENT_COUNT];
+
+  bool has(PerfEvent event) const { return counts[event] >= 0; }
+
+  // Instructions per cycle, or -1 without both counts.
+  double ipc() const {
+    if (!has(PERF_CYCLES) || !has(PERF_INSTRUCTIONS) ||
+        counts[PERF_CYCLES] == 0)
+      return -1;
+    return static_cast<double>(counts[PERF_INSTRUCTIONS]) /
+           counts[PERF_CYCLES];
+  }
+
+  // Events per thousand instructions (MPKI for the miss events), or -1.
+  double perKiloInstruction(PerfEvent event) const {
+    if (!has(event) || !has(PERF_INSTRUCTIONS) ||
+        counts[PERF_INSTRUCTIONS] == 0)
+      return -1;
+    return 1000.0 * counts[event] / counts[PERF_INSTRUCTIONS];
+  }
+};
+
+class PerfCounterGroup {
+public:
+  PerfCounterGroup();
+  ~PerfCounterGroup();
+
+  bool available() const;
+  void start();
+  PerfSample stop();
+
+private:
+  PerfCounter *counters[PERF_EVENT_COUNT];
+
+  PerfCounterGroup(const PerfCounterGroup &);
+  PerfCounterGroup &operator=(const PerfCounterGroup &);
+};
+
+/*
+Description: Opens the counter, disabled until start() is called.
+Parameters: Event to count.
+Return: None
+*/
+inline PerfCounter::PerfCounter(PerfEvent event) : fd(-1) {
+#ifdef __linux__
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.inherit = 1; // worker threads of the parallel sorts count too
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  attr.type = PERF_TYPE_HARDWARE;
+  switch (event) {
+  case PERF_CYCLES:
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case PERF_INSTRUCTIONS:
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case PERF_L1D_MISSES:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_L1D |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    break;
+  case PERF_LLC_MISSES:
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    break;
+  case PERF_BRANCH_MISSES:
+    attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+    break;
+  case PERF_DTLB_MISSES:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    break;
+  default:
+    return;
+  }
+  fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+  (void)event;
+#endif
+}
+
+/*
+Description: Closes the counter.
+Parameters: None
+Return: None
+*/
+inline PerfCounter::~PerfCounter() {
+#ifdef __linux__
+  if (fd >= 0)
+    close(fd);
+#endif
+}
+
+/*
+Description: Resets the counter to zero and starts counting.
+Parameters: None
+Return: None
+*/
+inline void PerfCounter::start() {
+#ifdef __linux__
+  if (fd < 0)
+    return;
+  ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+/*
+Description: Stops counting and reads the count, scaled up by the share of
+the region the counter was actually scheduled on the CPU.
+Parameters: None
+Return: Number of events since start(), or -1 if the counter is unavailable
+or never got scheduled.
+*/
+inline long long PerfCounter::stop() {
+#ifdef __linux__
+  if (fd < 0)
+    return -1;
+  ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  unsigned long long values[3]; // count, time enabled, time running
+  if (read(fd, values, sizeof(values)) != sizeof(values) || values[2] == 0)
+    return -1;
+  if (values[2] < values[1])
+    return static_cast<long long>(static_cast<double>(values[0]) *
+                                  values[1] / values[2]);
+  return values[0];
+#else
+  return -1;
+#endif
+}
+
+/*
+Description: Opens one counter per event.
+Parameters: None
+Return: None
+*/
+inline PerfCounterGroup::PerfCounterGroup() {
+  for (int e = 0; e < PERF_EVENT_COUNT; e++)
+    counters[e] = new PerfCounter(static_cast<PerfEvent>(e));
+}
+
+/*
+Description: Closes the counters.
+Parameters: None
+Return: None
+*/
+inline PerfCounterGroup::~PerfCounterGroup() {
+  for (int e = 0; e < PERF_EVENT_COUNT; e++)
+    delete counters[e];
+}
+
+/*
+Description: Whether any of the counters could be opened.
+Parameters: None
+Return: True if at least one event is counted.
+*/
+inline bool PerfCounterGroup::available() const {
+  for (int e = 0; e < PERF_EVENT_COUNT; e++)
+    if (counters[e]->available())
+      return true;
+  return false;
+}
+
+/*
+Description: Resets and starts every counter.
+Parameters: None
+Return: None
+*/
+inline void PerfCounterGroup::start() {
+  for (int e = 0; e < PERF_EVENT_COUNT; e++)
+    counters[e]->start();
+}
+
+/*
+Description: Stops every counter, in the reverse order they were started so
+the region each one covers is as close as possible to the same.
+Parameters: None
+Return: The counts, -1 for the unavailable events.
+*/
+inline PerfSample PerfCounterGroup::stop() {
+  PerfSample sample;
+  for (int e = PERF_EVENT_COUNT - 1; e >= 0; e--)
+    sample.counts[e] = counters[e]->stop();
+  return sample;
+}
+
+/*
+Description: Prints a sample on one line, with the IPC and the misses per
+thousand instructions, and N/A for the unavailable counters.
+Parameters: Output stream and the sample.
+Return: None
+*/
+inline void printPerfSample(std::ostream &out, const PerfSample &sample) {
+  for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+    out << (e ? ", " : "") << perfEventName(static_cast<PerfEvent>(e))
+        << ": ";
+    if (sample.counts[e] >= 0)
+      out << sample.counts[e];
+    else
+      out << "N/A";
+  }
+  out << ", ipc: ";
+  if (sample.ipc() >= 0)
+    out << sample.ipc();
+  else
+    out << "N/A";
+  for (int e = PERF_L1D_MISSES; e < PERF_EVENT_COUNT; e++) {
+    PerfEvent event = static_cast<PerfEvent>(e);
+    out << ", " << perfEventName(event) << " per 1k instructions: ";
+    if (sample.perKiloInstruction(event) >= 0)
+      out << sample.perKiloInstruction(event);
+    else
+      out << "N/A";
+  }
+}
+
+#endif /* PERFCOUNTERS_H_ */
@@ -1,208 +1,635 @@
 /*Author: JJ McCauley
 Creation Date: 3/8/24
-Last Update: 3/8/24
+Last Update: 10/17/26
 Description: This program works with the header file "Sorts.h" to time various different
-comparison and non-comparison based sorting algorithms. The program will receive the number
-of arrays to sort from the user and the sizes for each respective array, then will randomly
-assign integers to those arrays. The main function will then call each sort, timing it's
-execution and logging it in a csv file called "SortTImes.csv". The array will be bounded
-to either a range or floats when necessary.
-User Interface: User will be asked for a number of arrays to be tested and the
-array sizes via the console.
+comparison and non-comparison based sorting algorithms. For every array size given on the
+command line it randomly assigns integers to an array, then times each sort with the
+benchmark harness in "Benchmark.h": every trial sorts a fresh copy of the input, warmup
+trials run first, and trials repeat until the 95% confidence interval is tight enough.
+Every sort that takes the key type is also timed on every input distribution in
+"Distributions.h" (uniform, sorted, reversed, sawtooth, organ pipe, few unique, Zipf,
+Gaussian, k-sorted, all equal and sorted with appends) for 32 and 64 bit integers, floats,
+doubles and strings, all generated from the --seed flag so every run sees the same inputs.
+The median, 5th and 95th percentile times, time per element and throughput of every sort
+are logged in a csv file ("SortTimes.csv" by default) and optionally a JSON file, along
+with the peak heap memory each sort allocated, which is counted by replacing the global
+operator new and delete. The
+array will be bounded to either a range or floats when necessary.
+User Interface: project1 --sizes <size,size,...> [options], see printUsage for the options.
 Notes: Algorithms and code were taken from either Data Structures and Algorithms 
 in C++ by Adam Drozdek or Introduction to Algorithms Fourth Edition by Cormen, 
 Leiserson, Rivest, and Stein */
 
 //Header file provided by Dr. Spickler containing the different sorting algortihms
 #include "Sorts.h" 
+//Benchmark harness: repeated trials, CPU pinning and the CSV and JSON results
+#include "Benchmark.h"
 //Allows communication via the standard output
 #include <iostream>
 //Allows output to a file
 #include <fstream>
-//Timing with Chrono and randomly generating integers
+//Seeded input distributions for integer, float and string keys
+#include "Distributions.h"
+//Parsing the command line arguments
 #include <cstdlib>
-#include <ctime>
-#include <chrono>
+//Skewing the random floats with pow
+#include <cmath>
+//Cauchy distribution for the heavy-tailed float benchmarks
+#include <random>
 //Getting the "algorithm"'s library sort algorithm
 #include <algorithm>
+//Allocating through malloc in the operator new replacement
+#include <new>
+//Case names and the list of sizes
+#include <string>
+#include <vector>
 
 using namespace std;
-using namespace chrono;
 
 /* Function Pointer to sort to the different functions, cleaning up main function */
 using sortPtr = void(*)(int *, int); //Pass in the array and size
 
+/* Adversary used to build quick sort "killer" inputs (McIlroy, "A Killer Adversary
+for Quicksort"). Keys start out as "gas" and are frozen to increasing values only
+when the sort compares two gas keys, which forces every pivot to be a minimum. */
+struct AdversaryKey {
+    int index;
+};
+//Killer inputs are only generated, and the classic quick sort only timed on adversarial
+//inputs, up to this size since both are quadratic
+const int KILLER_LIMIT = 20000;
+int *adversaryValues;
+int adversaryGas, adversarySolid, adversaryCandidate;
+int adversaryCompare(int, int);
+bool operator<(AdversaryKey a, AdversaryKey b) { return adversaryCompare(a.index, b.index) < 0; }
+bool operator>(AdversaryKey a, AdversaryKey b) { return adversaryCompare(a.index, b.index) > 0; }
+
+/* Record with a 60 byte payload, used to compare sorting whole structs against sorting
+a key array and a payload array with the key-value sorts */
+const int PAYLOAD_BYTES = 60;
+struct Payload {
+    char bytes[PAYLOAD_BYTES];
+};
+struct FatRecord {
+    int key;
+    Payload payload;
+};
+bool operator<(const FatRecord &a, const FatRecord &b) { return a.key < b.key; }
+bool operator>(const FatRecord &a, const FatRecord &b) { return a.key > b.key; }
+
+/* Seed state for the generated inputs, set by the --seed flag */
+uint64_t inputSeed = 1;
+
+
 /* Function Prototypes */
-//Retrieving and validating input for the number of arrays to be tested
-int getNumArrays();
-/*Tetrieve and validate input for the number of elements in each array, in which is returned 
-via an int pointer */
-int *getSizes(int);
+//Read the command line flags into the harness options, sizes, output paths and thread count
+bool parseOptions(int, char *[], BenchmarkOptions &, vector<int> &, string &, string &, int &);
+//Print the command line flags the program accepts
+void printUsage();
+//Return the seed for the next generated input
+uint64_t nextInputSeed();
 //Return a pointer to an array of randomly generated integers, given size
 int *getRandomArray(int);
 //Return a pointer to an array of randomly generated floats
 float *getRandomFloatArray(int);
+//Return random floats from a standard normal or a heavy-tailed (Cauchy) distribution
+float *getNormalFloatArray(int);
+float *getHeavyTailedFloatArray(int);
 //Given bounds, will set a max and min of the array
 int *applyBounds(int *, int, int);
-//Start the chrono timer and return the start time
-chrono::time_point<std::chrono::high_resolution_clock> startTimer();
-//Stop the chrono timer and return time elasped, given start as parameter
-double endTimer(chrono::time_point<std::chrono::high_resolution_clock>);
-//Will time the given function and output the time to the outfile
-void logTime(int *, int, ofstream &, sortPtr);
+//Adversarial inputs for the quick sorts: ascending, descending and organ-pipe arrays
+int *getSortedArray(int);
+int *getReversedArray(int);
+int *getOrganPipeArray(int);
+//Presorted inputs for the adaptive sorts: k-sorted, a few sorted runs, sorted with a random tail
+int *getKSortedArray(int);
+int *getFewRunsArray(int);
+int *getAppendedTailArray(int);
+//Return an array that drives quickSort to its quadratic worst case, or nullptr when too large
+int *getQuickSortKillerArray(int);
+//Time a sort on fresh copies of the array, given the case name and the threads it uses
+template <class E, class Sort>
+void logTimeCopy(E *, int, Benchmark &, const string &, Sort, int threads = 1);
+//Will time the given function under the given case name
+void logTime(int *, int, Benchmark &, const string &, sortPtr);
 //Time the sort for the sorting method from the algorithm library
-void logTimeAlgSort(int *, int, ofstream &);
+void logTimeAlgSort(int *, int, Benchmark &, const string &);
 //Overloaded for radix sort
-void logTimeRadix(int *, int, ofstream &, int);
+void logTimeRadix(int *, int, Benchmark &, const string &, int);
 //Overloaded for bucket sort
-void logTimeBucket(float *, int, ofstream &);
-//Overloaded for count sort
-void logTimeCount(int *, int, ofstream &);
+void logTimeBucket(float *, int, Benchmark &, const string &, int threads = 1);
+//Time a float sort: bucket sort (variant 0), float radix sort (1) or the library sort (2)
+void logTimeFloat(float *, int, Benchmark &, const string &, int);
+//Overloaded for count sort, given the number of threads and whether an int payload is sorted along
+void logTimeCount(int *, int, Benchmark &, const string &, int threads = 1, bool payload = false);
+//Overloaded for the parallel merge sort, given the number of threads
+void logTimeParallel(int *, int, Benchmark &, const string &, int);
+//Overloaded for the parallel sample sort, given the number of threads
+void logTimeSample(int *, int, Benchmark &, const string &, int);
+//Time sorting records by key, either as structs (variant 0) or as separate key and payload
+//arrays with the merge (1), quick (2) or radix (3) key-value sort
+void logTimeRecords(int *, int, Benchmark &, const string &, int);
+//Time selecting the k smallest entries with nth element (variant 0), partial sort (1),
+//streaming top-k over chunks (2) or parallel top-k with the given number of threads (3)
+void logTimeSelect(int *, int, Benchmark &, const string &, int, int, int threads = 1);
+//Time combining the given number of sorted shards, either concatenated and merge sorted
+//(variant 0) or merged in one pass by the multiway merge with the given number of threads (1)
+void logTimeShards(int *, int, Benchmark &, const string &, int, int, int threads = 1);
+//Overloaded for the SIMD sorting networks, given the block width
+void logTimeNetwork(int *, int, Benchmark &, const string &, int);
+//The original recursive quick sort, which quickSort(A, size) no longer uses for ints
+void classicQuickSort(int *, int);
+//The original top-down merge sort, which mergeSort(A, size) no longer uses
+void recursiveMergeSort(int *, int);
+//Time the bottom-up merge sort while reusing one scratch buffer for every trial
+void logTimeMergeScratch(int *, int, Benchmark &, const string &);
+//Tim sort without a caller-supplied scratch buffer, so it matches sortPtr
+void adaptiveTimSort(int *, int);
+//In-place merge sort without any buffer, so it matches sortPtr
+void noBufferMergeSort(int *, int);
+//Time every sort that takes the key type on every input distribution, given the type's name
+template <class T> void logTimeDistributions(int, Benchmark &, const string &, int);
 
 
-int main() {
-    cout << "Welcome to JJ's Sort Timer Program!" << endl; //Introduction message
-    int numArrays = getNumArrays(); //Get the number of arrays and assign to numArrays
-    int *arraySizes = getSizes(numArrays); //Hold the size of each array
-    int size; //Stores the size of the current array
+int main(int argc, char *argv[]) {
+    BenchmarkOptions options; //Trial counts, confidence target, CPU and case filter
+    vector<int> arraySizes; //Hold the size of each array
+    string csvPath = "SortTimes.csv", jsonPath; //No JSON file unless one is asked for
+    //Parallel sorts are timed for every thread count up to the number of cores
+    int maxThreads = max(1u, thread::hardware_concurrency());
+    if(!parseOptions(argc, argv, options, arraySizes, csvPath, jsonPath, maxThreads)) {
+        printUsage();
+        return 1;
+    }
 
-    ofstream outFile("SortTimes.csv"); //Open the file to output the data into
-    if(!outFile.is_open()) {
-        cout << "Error - could not open file" << endl;
+    cout << "Welcome to JJ's Sort Timer Program!" << endl; //Introduction message
+    heapTracked = true; //operator new and delete below report every allocation
+    Benchmark bench(options);
+    if(bench.pinned()) {
+        cout << "Pinned to CPU " << bench.cpu() << endl;
     }
-    //Print the headers for the output file
-    outFile << ",Merge Sort,Quick Sort,Comb Sort,Shell Sort,Heap Sort,Algorithm Library Sort,Radix Sort (Radix=10)";
-    outFile << ",Radix Sort (Radix=100),Radix Sort (Radix=1000),Radix Sort (Radix=10000),Count Sort,Bucket Sort,";
-    outFile << "Radix Sort (Radix=10 & Max=1000),Radix Sort (Radix=100 & Max=1000),Radix Sort (Radix=100 & Max=1000),";
-    outFile << "Radix Sort (Radix=10000 & Max=1000),Count Sort (Max=1000)";
     cout << "Sorting now..." << endl;
     //Iterate through each sorting algorthim
-    for(int i = 0; i < numArrays; i++) {
-        size = arraySizes[i];
-        outFile << "\n" << size << ",";
+    for(size_t i = 0; i < arraySizes.size(); i++) {
+        int size = arraySizes[i];
         int *array = getRandomArray(size);
-        logTime(array, size, outFile, mergeSort);
-        logTime(array, size, outFile, quickSort);
-        logTime(array, size, outFile, combsort);
-        logTime(array, size, outFile, Shellsort);
-        logTime(array, size, outFile, heapsort);
-        logTimeAlgSort(array, size, outFile);
-        logTimeRadix(array, size, outFile, 10);
-        logTimeRadix(array, size, outFile, 100);
-        logTimeRadix(array, size, outFile, 1000);
-        logTimeRadix(array, size, outFile, 10000);
-        logTimeCount(array, size, outFile);
+        logTime(array, size, bench, "Merge Sort", mergeSort);
+        logTime(array, size, bench, "Quick Sort", quickSort);
+        logTime(array, size, bench, "Comb Sort", combsort);
+        logTime(array, size, bench, "Shell Sort", Shellsort);
+        //Time Shell sort with every gap sequence
+        ShellGaps gapSequences[] = {SHELL_KNUTH, SHELL_CIURA, SHELL_TOKUDA, SHELL_SEDGEWICK};
+        const char *gapNames[] = {"Knuth", "Ciura", "Tokuda", "Sedgewick"};
+        for(int g = 0; g < 4; g++) {
+            ShellGaps sequence = gapSequences[g];
+            logTimeCopy(array, size, bench, string("Shell Sort (") + gapNames[g] + " Gaps)",
+                        [sequence](int *a, int n) { Shellsort(a, n, sequence); });
+        }
+        logTime(array, size, bench, "Heap Sort", heapsort);
+        logTimeAlgSort(array, size, bench, "Algorithm Library Sort");
+        for(int radix = 10; radix <= 10000; radix *= 10) {
+            logTimeRadix(array, size, bench, "Radix Sort (Radix=" + to_string(radix) + ")", radix);
+        }
+        logTimeCount(array, size, bench, "Count Sort");
         array = applyBounds(array, size, 1000);
-        logTimeRadix(array, size, outFile, 10);
-        logTimeRadix(array, size, outFile, 100);
-        logTimeRadix(array, size, outFile, 1000);
-        logTimeRadix(array, size, outFile, 10000);
-        logTimeCount(array, size, outFile);
+        for(int radix = 10; radix <= 10000; radix *= 10) {
+            logTimeRadix(array, size, bench, "Radix Sort (Radix=" + to_string(radix) + " & Max=1000)", radix);
+        }
+        logTimeCount(array, size, bench, "Count Sort (Max=1000)");
         float *fArray = getRandomFloatArray(size);
-        logTimeBucket(fArray, size, outFile);
+        logTimeBucket(fArray, size, bench, "Bucket Sort");
+        for(int t = 1; t <= maxThreads; t++) {
+            logTimeParallel(array, size, bench, "Parallel Merge Sort (" + to_string(t) + " Threads)", t);
+        }
+        logTime(array, size, bench, "Intro Sort", introSort);
+        logTime(array, size, bench, "PDQ Sort", pdqSort);
+        logTime(array, size, bench, "Three-Way Quick Sort", threeWayQuickSort);
+        logTime(array, size, bench, "Dual-Pivot Quick Sort", dualPivotQuickSort);
+        //Time the quick sorts on the adversarial inputs
+        int *(*adversaries[])(int) = {getSortedArray, getReversedArray, getOrganPipeArray,
+                                      getQuickSortKillerArray};
+        const char *adversaryNames[] = {"Sorted", "Reversed", "Organ Pipe", "Killer"};
+        for(int a = 0; a < 4; a++) {
+            int *advArray = adversaries[a](size);
+            if(advArray == nullptr) {
+                continue;
+            }
+            string input = string(" (") + adversaryNames[a] + ")";
+            //The classic quick sort is quadratic with unbounded recursion on these inputs,
+            //so like the killer array it is only timed up to KILLER_LIMIT
+            if(size <= KILLER_LIMIT) {
+                logTime(advArray, size, bench, "Quick Sort" + input, classicQuickSort);
+            }
+            logTime(advArray, size, bench, "Intro Sort" + input, introSort);
+            logTime(advArray, size, bench, "PDQ Sort" + input, pdqSort);
+            delete[] advArray;
+        }
+        for(int width = 8; width <= NETWORK_MAX_BLOCK; width *= 2) {
+            logTimeNetwork(array, size, bench, "Network Sort (Width=" + to_string(width) + ")", width);
+        }
+        logTime(array, size, bench, "Quick Sort (Classic)", classicQuickSort);
+        logTime(array, size, bench, "Merge Sort (Recursive)", recursiveMergeSort);
+        logTimeMergeScratch(array, size, bench, "Merge Sort (Reused Buffer)");
+        logTime(array, size, bench, "Tim Sort", adaptiveTimSort);
+        logTime(array, size, bench, "In-Place Merge Sort (Sqrt Buffer)", inPlaceMergeSort);
+        logTime(array, size, bench, "In-Place Merge Sort (No Buffer)", noBufferMergeSort);
+        //Time the adaptive sort against the merge sort on the presorted inputs
+        int *(*presorted[])(int) = {getKSortedArray, getFewRunsArray, getAppendedTailArray};
+        const char *presortedNames[] = {"k-Sorted", "Few Runs", "Appended Tail"};
+        for(int a = 0; a < 3; a++) {
+            int *preArray = presorted[a](size);
+            string input = string(" (") + presortedNames[a] + ")";
+            logTime(preArray, size, bench, "Merge Sort" + input, mergeSort);
+            logTime(preArray, size, bench, "Tim Sort" + input, adaptiveTimSort);
+            logTimeAlgSort(preArray, size, bench, "Algorithm Library Sort" + input);
+            delete[] preArray;
+        }
+        //Sample sort is timed on unbounded keys so the splitters are distinct
+        int *sampleArray = getRandomArray(size);
+        for(int t = 1; t <= maxThreads; t++) {
+            logTimeSample(sampleArray, size, bench, "Sample Sort (" + to_string(t) + " Threads)", t);
+        }
+        delete[] sampleArray;
+        logTimeCount(array, size, bench, "Count Sort (Max=1000 & " + to_string(maxThreads) + " Threads)",
+                     maxThreads);
+        int *negativeArray = new int[size];
+        for(int j = 0; j < size; j++) {
+            negativeArray[j] = array[j] - 500;
+        }
+        logTimeCount(negativeArray, size, bench, "Count Sort (Min=-500 & Max=500)");
+        delete[] negativeArray;
+        logTimeCount(array, size, bench, "Count Sort By Key (Max=1000)", 1, true);
+        //Heap Sort above uses the 4-ary heap; time the original binary heap and an 8-ary heap
+        int *heapArray = getRandomArray(size);
+        logTime(heapArray, size, bench, "Heap Sort (Binary)", binaryHeapsort);
+        logTime(heapArray, size, bench, "Heap Sort (8-ary)", dAryHeapsort<8, int>);
+        delete[] heapArray;
+        logTimeBucket(fArray, size, bench, "Bucket Sort (" + to_string(maxThreads) + " Threads)", maxThreads);
+        //Raising the floats to the eighth power crowds most of them next to 0
+        for(int j = 0; j < size; j++) {
+            fArray[j] = pow(fArray[j], 8.0f);
+        }
+        logTimeBucket(fArray, size, bench, "Bucket Sort (Skewed)");
+        delete[] fArray;
+        //Compare the float sorts on uniform, normal and heavy-tailed floats
+        float *(*floatGenerators[])(int) = {getRandomFloatArray, getNormalFloatArray,
+                                            getHeavyTailedFloatArray};
+        const char *floatDists[] = {"Uniform", "Normal", "Heavy-Tailed"};
+        const char *floatSorts[] = {"Bucket Sort", "Float Radix Sort", "Algorithm Library Sort"};
+        for(int d = 0; d < 3; d++) {
+            float *distArray = floatGenerators[d](size);
+            for(int variant = 0; variant < 3; variant++) {
+                logTimeFloat(distArray, size, bench,
+                             string(floatSorts[variant]) + " (" + floatDists[d] + " Floats)", variant);
+            }
+            delete[] distArray;
+        }
+        const char *recordSorts[] = {"Intro Sort", "Merge Sort By Key", "Quick Sort By Key",
+                                     "Radix Sort By Key"};
+        for(int variant = 0; variant < 4; variant++) {
+            logTimeRecords(array, size, bench, string(recordSorts[variant]) + " (64-Byte Records)", variant);
+        }
+        //Selection is timed for k as a fraction of the size, to compare with the full Quick Sort
+        int *selectArray = getRandomArray(size);
+        const double selectFractions[] = {0.001, 0.01, 0.1, 0.5};
+        const char *selectLabels[] = {"0.1%", "1%", "10%", "50%"};
+        const char *selectNames[] = {"Nth Element", "Partial Sort", "Streaming Top-k"};
+        for(int f = 0; f < 4; f++) {
+            int k = max(1, static_cast<int>(size * selectFractions[f]));
+            string label = string(" (k=") + selectLabels[f];
+            for(int variant = 0; variant < 3; variant++) {
+                logTimeSelect(selectArray, size, bench, selectNames[variant] + label + ")", k, variant);
+            }
+            logTimeSelect(selectArray, size, bench,
+                          "Parallel Top-k" + label + " & " + to_string(maxThreads) + " Threads)", k, 3,
+                          maxThreads);
+        }
+        delete[] selectArray;
+        int *shardArray = getRandomArray(size);
+        for(int shards = 8; shards <= 512; shards *= 8) {
+            string label = " (" + to_string(shards) + " Shards";
+            logTimeShards(shardArray, size, bench, "Merge Sort" + label + ")", shards, 0);
+            logTimeShards(shardArray, size, bench, "Multiway Merge" + label + ")", shards, 1);
+            logTimeShards(shardArray, size, bench,
+                          "Multiway Merge" + label + " & " + to_string(maxThreads) + " Threads)", shards, 1,
+                          maxThreads);
+        }
+        delete[] shardArray;
+        //Time every sort against every input distribution and key type
+        logTimeDistributions<int>(size, bench, "int32", maxThreads);
+        logTimeDistributions<long long>(size, bench, "int64", maxThreads);
+        logTimeDistributions<float>(size, bench, "float", maxThreads);
+        logTimeDistributions<double>(size, bench, "double", maxThreads);
+        logTimeDistributions<string>(size, bench, "string", maxThreads);
+        delete[] array;
         cout << "Array " << i << " Sorted..." << endl;
     } 
+
+    ofstream outFile(csvPath); //Open the file to output the data into
+    if(!outFile.is_open()) {
+        cout << "Error - could not open file " << csvPath << endl;
+        return 1;
+    }
+    bench.writeCSV(outFile);
     outFile.close();
-    cout << "Sorting Completed! Check the SortTimes.csv file for the results." << endl;
+    if(!jsonPath.empty()) {
+        ofstream jsonFile(jsonPath);
+        if(!jsonFile.is_open()) {
+            cout << "Error - could not open file " << jsonPath << endl;
+            return 1;
+        }
+        bench.writeJSON(jsonFile);
+    }
+    cout << "Sorting Completed! Check the " << csvPath << " file for the results." << endl;
 }
 
-/*Description: This function asks the user for a number of arrays via the console, 
-validates the input to ensure that it is positive, and returns that number.
-Parameters: N/A
-Return: int: Return the number of arrays the user would like to sort
+/*Description: This function reads the command line flags. Every flag is followed by its
+value, and sizes are given as a comma separated list.
+Parameters: int argc, char *argv[]: The command line arguments
+BenchmarkOptions &options: The harness options to fill in
+vector<int> &sizes: The array sizes to time
+string &csvPath, string &jsonPath: The output files, an empty JSON path writes no JSON
+int &maxThreads: The largest thread count the parallel sorts are timed with
+Return: bool: false if a flag or value is invalid or no sizes were given
 Notes: N/A */
-int getNumArrays() {
-    int numArrays;
-    bool valid = false;
-    while(!valid) {
-        cout << "Enter the number of arrays you would like to sort: ";
-        cin >> numArrays;
-        if(numArrays < 0 || numArrays > 9999) {
-            cout << "Invalid number, please try again";
+bool parseOptions(int argc, char *argv[], BenchmarkOptions &options, vector<int> &sizes,
+                  string &csvPath, string &jsonPath, int &maxThreads) {
+    for(int i = 1; i < argc; i += 2) {
+        if(i + 1 >= argc) {
+            return false;
+        }
+        string flag = argv[i];
+        const char *value = argv[i + 1];
+        char *end;
+        double number = strtod(value, &end);
+        bool numeric = *value != '\0' && *end == '\0';
+        if(flag == "--sizes") {
+            for(const char *p = value; *p != '\0'; p = *end == ',' ? end + 1 : end) {
+                long size = strtol(p, &end, 10);
+                if(end == p || size < 0 || size > 99999999 || (*end != ',' && *end != '\0')) {
+                    return false;
+                }
+                sizes.push_back(size);
+            }
+        }
+        else if(flag == "--csv") {
+            csvPath = value;
+        }
+        else if(flag == "--json") {
+            jsonPath = value;
+        }
+        else if(flag == "--filter") {
+            options.filter = value;
+        }
+        else if(!numeric) {
+            return false;
+        }
+        else if(flag == "--warmups" && number >= 0) {
+            options.warmups = number;
+        }
+        else if(flag == "--min-trials" && number >= 1) {
+            options.minTrials = number;
+        }
+        else if(flag == "--max-trials" && number >= 1) {
+            options.maxTrials = number;
+        }
+        else if(flag == "--confidence" && number > 0) {
+            options.confidence = number;
+        }
+        else if(flag == "--max-seconds" && number > 0) {
+            options.maxSeconds = number;
+        }
+        else if(flag == "--cpu" && number >= -1) {
+            options.cpu = number;
+        }
+        else if(flag == "--threads" && number >= 1) {
+            maxThreads = number;
+        }
+        else if(flag == "--seed" && number >= 0) {
+            inputSeed = strtoull(value, nullptr, 10);
         }
         else {
-            valid = true;
+            return false;
         }
     }
-    return numArrays;
+    return !sizes.empty();
 }
 
-/*Description: This function asks the user for the array of size of each array
-to be sorted, validating the input.
-Parameters: int numofArrays: The number of arrays the user would like to sort
-Return: int pointer: A pointer to an array of array sizes
+/*Description: This function prints the command line flags the program accepts.
+Parameters: N/A
+Return: N/A
 Notes: N/A */
-int *getSizes(int numOfArrays) {
-    int size;
-    bool valid;
-    int *sizeArr = new int[numOfArrays]; //An array for the different sizes
-    for(int i = 0; i < numOfArrays; i++) {
-        valid = false;
-        while(!valid) {
-            cout << "Enter size of array " << i+1 << ": ";
-            cin >> size;
-            if(size < 0 || size > 99999999) {
-                cout << "Invalid size, please try again" << endl;
-            }
-            else {
-                valid = true;
-            }
-        }
-        *(sizeArr+i) = size;
-    }
-    return sizeArr;
+void printUsage() {
+    cout << "Usage: project1 --sizes <size,size,...> [flags]" << endl;
+    cout << "  --csv <file>          CSV results (default SortTimes.csv)" << endl;
+    cout << "  --json <file>         JSON results for regression tracking" << endl;
+    cout << "  --filter <text>       only time sorts whose name contains the text" << endl;
+    cout << "  --warmups <n>         untimed trials before measuring (default 1)" << endl;
+    cout << "  --min-trials <n>      trials before checking the interval (default 5)" << endl;
+    cout << "  --max-trials <n>      most trials per sort (default 50)" << endl;
+    cout << "  --confidence <f>      target 95% interval as a fraction of the mean (default 0.02)" << endl;
+    cout << "  --max-seconds <s>     most measuring time per sort (default 2)" << endl;
+    cout << "  --cpu <n>             CPU to pin to, -1 to not pin (default 0)" << endl;
+    cout << "  --threads <n>         most threads for the parallel sorts (default all cores)" << endl;
+    cout << "  --seed <n>            seed for the generated inputs (default 1)" << endl;
+}
+
+/*Description: This function returns the seed for the next generated input. The seeds
+follow from the --seed flag, so every run with the same flags times the same inputs.
+Parameters: N/A
+Return: uint64_t: The seed
+Notes: N/A */
+uint64_t nextInputSeed() {
+    return splitMix64(inputSeed);
 }
 
 /*Description: This function will create the arrays of random integers, returning the
 new array.
 Parameters: int size: The size of the array to be assigned
-Return: int pointer: A pointer to an array random integers
+Return: int pointer: A pointer to an array of random non-negative integers
 Notes: N/A */
 int *getRandomArray(int size) {
     int *randArr = new int[size];
-    srand(time(0)); //Seed the random number generator
-    //Create an array with bounds, with '0' being a signal value
-    for(int i = 0; i < size; i++) {
-        *(randArr+i) = rand();
-    }
+    generate(randArr, size, DIST_UNIFORM, nextInputSeed());
     return randArr;    
 }
 
 /*Description: This function will create the arrays of random floats, returning the
 new array.
 Parameters: int size: The size of the array to be assigned
-Return: float pointer: A pointer to an array of random float values
+Return: float pointer: A pointer to an array of random float values in [0, 1)
 Notes: N/A */
 float *getRandomFloatArray(int size) {
     float *randArr = new float[size];
-    srand(time(0)); //Seed the random number generator
-    //Create an array with bounds, with '0' being a signal value
+    generate(randArr, size, DIST_UNIFORM, nextInputSeed());
+    return randArr;
+}
+
+/*Description: These functions create arrays of floats drawn from a standard normal
+distribution and from a Cauchy distribution, whose heavy tails spread a few keys
+very far from the rest.
+Parameters: int size: The size of the array to be assigned
+Return: float pointer: A pointer to the new array
+Notes: N/A */
+float *getNormalFloatArray(int size) {
+    float *arr = new float[size];
+    generate(arr, size, DIST_GAUSSIAN, nextInputSeed());
+    return arr;
+}
+
+float *getHeavyTailedFloatArray(int size) {
+    float *arr = new float[size];
+    Xoshiro256 generator(nextInputSeed());
+    cauchy_distribution<float> dist(0.0f, 1.0f);
     for(int i = 0; i < size; i++) {
-        *(randArr+i) = static_cast<float>(rand())/RAND_MAX;
+        arr[i] = dist(generator);
     }
-    return randArr;
+    return arr;
 }
 
-/*Description: This helper function starts the Chrono timer
-Parameters: N/A
-Return: chrono::time_point<std::chrono::high_resolution_clock>: A value holding 
-the start time
+/*Description: These functions create the ascending, descending and organ-pipe
+(ascending first half, descending second half) arrays used to attack the quick sorts.
+Parameters: int size: The size of the array to be assigned
+Return: int pointer: A pointer to the new array
+Notes: N/A */
+int *getSortedArray(int size) {
+    int *arr = new int[size];
+    generate(arr, size, DIST_SORTED, nextInputSeed());
+    return arr;
+}
+
+int *getReversedArray(int size) {
+    int *arr = new int[size];
+    generate(arr, size, DIST_REVERSED, nextInputSeed());
+    return arr;
+}
+
+int *getOrganPipeArray(int size) {
+    int *arr = new int[size];
+    generate(arr, size, DIST_ORGAN_PIPE, nextInputSeed());
+    return arr;
+}
+
+/*Description: These functions create the presorted arrays used to show the benefit
+of the adaptive tim sort. The k-sorted array has every entry within K_SORTED_WINDOW
+of its sorted position, the few runs array is FEW_RUNS ascending runs of random values,
+and the appended tail array is sorted except for a random last APPENDED_PERCENT
+percent, like a sorted log with new entries appended.
+Parameters: int size: The size of the array to be assigned
+Return: int pointer: A pointer to the new array
+Notes: N/A */
+const int FEW_RUNS = 8;
+
+int *getKSortedArray(int size) {
+    int *arr = new int[size];
+    generate(arr, size, DIST_K_SORTED, nextInputSeed());
+    return arr;
+}
+
+int *getFewRunsArray(int size) {
+    int *arr = getRandomArray(size);
+    for(int r = 0; r < FEW_RUNS; r++) {
+        std::sort(arr + static_cast<long>(size) * r / FEW_RUNS,
+                  arr + static_cast<long>(size) * (r + 1) / FEW_RUNS);
+    }
+    return arr;
+}
+
+int *getAppendedTailArray(int size) {
+    int *arr = new int[size];
+    generate(arr, size, DIST_SORTED_APPENDS, nextInputSeed());
+    return arr;
+}
+
+/*Description: This function compares two keys for the quick sort adversary. When both
+keys are still "gas" one of them is frozen, and the key that stays gas becomes the
+candidate pivot, so it is frozen as late as possible.
+Parameters: int x, int y: The indices of the keys being compared
+Return: int: negative, zero or positive as in strcmp
+Notes: N/A */
+int adversaryCompare(int x, int y) {
+    if(adversaryValues[x] == adversaryGas && adversaryValues[y] == adversaryGas) {
+        if(x == adversaryCandidate) {
+            adversaryValues[x] = adversarySolid++;
+        }
+        else {
+            adversaryValues[y] = adversarySolid++;
+        }
+    }
+    if(adversaryValues[x] == adversaryGas) {
+        adversaryCandidate = x;
+    }
+    else if(adversaryValues[y] == adversaryGas) {
+        adversaryCandidate = y;
+    }
+    return adversaryValues[x] - adversaryValues[y];
+}
+
+/*Description: This function runs quickSort against the adversary and returns the keys
+it decided on, which make quickSort take quadratic time when sorted again.
+Parameters: int size: The size of the array to be assigned
+Return: int pointer: A pointer to the killer array, or nullptr if size is over KILLER_LIMIT
+Notes: N/A */
+int *getQuickSortKillerArray(int size) {
+    if(size > KILLER_LIMIT) {
+        return nullptr;
+    }
+    adversaryValues = new int[size];
+    adversaryGas = size;
+    adversarySolid = 0;
+    adversaryCandidate = 0;
+    AdversaryKey *keys = new AdversaryKey[size];
+    for(int i = 0; i < size; i++) {
+        adversaryValues[i] = adversaryGas;
+        keys[i].index = i;
+    }
+    quickSort(keys, 0, size - 1);
+    delete[] keys;
+    return adversaryValues;
+}
+
+/*Description: This function runs the recursive, middle-pivot quick sort from Sorts.h.
+quickSort(A, size) no longer reaches it, so this wrapper is the only caller left that
+times it, kept as the benchmark baseline for the other quick sorts (getQuickSortKillerArray
+also runs it, but only to build its killer input).
+Parameters: int *array: The array to be sorted
+int size: The size of the array
+Return: N/A
+Notes: N/A */
+void classicQuickSort(int *array, int size) {
+    quickSort(array, 0, size - 1);
+}
+
+/*Description: This function runs the adaptive tim sort from Sorts.h with a scratch
+buffer allocated for the call.
+Parameters: int *array: The array to be sorted
+int size: The size of the array
+Return: N/A
 Notes: N/A */
-chrono::time_point<std::chrono::high_resolution_clock> startTimer() {
-    auto start = chrono::high_resolution_clock::now();
-    return start;
+void adaptiveTimSort(int *array, int size) {
+    timSort(array, size);
 }
 
-/*Description: This helper function ends the chrono timer, returning the amount
-of time taken to execute.
-Parameters: start: The start time
-Return: double: Will return the time it took to execute the program, in milliseconds.
+/*Description: This function runs the in-place merge sort from Sorts.h without a buffer,
+so it uses O(1) extra memory besides its stack.
+Parameters: int *array: The array to be sorted
+int size: The size of the array
+Return: N/A
+Notes: N/A */
+void noBufferMergeSort(int *array, int size) {
+    inPlaceMergeSort(array, size, static_cast<int *>(nullptr), 0);
+}
+
+/*Description: This function runs the recursive merge sort from Sorts.h, which copies
+every merged range back into the array, with a temp array allocated for the call.
+Parameters: int *array: The array to be sorted
+int size: The size of the array
+Return: N/A
 Notes: N/A */
-double endTimer(chrono::time_point<std::chrono::high_resolution_clock> start) {
-    auto end = std::chrono::high_resolution_clock::now();
-    auto timeElasped = std::chrono::duration_cast<chrono::microseconds>(end-start);
-    //timeElasped = timeElasped/1000000; //convert to seconds
-    return (timeElasped.count());
+void recursiveMergeSort(int *array, int size) {
+    int *temp = new int[size];
+    mergeSort(array, temp, 0, size - 1);
+    delete[] temp;
 }
 
 /*Description: This function applies a "bound" to an array, returning the new 
@@ -219,130 +646,409 @@ int *applyBounds(int *array, int arraySize, int bounds) {
     return array;
 }
 
-/*Description: This function will create a new array copy called arrayCopy, ensuring
-that the original array does not get modified. It will then start the chronos timer, calling
-the startTimer helper funciton, then will run the provided sorting algorithm, end the timer 
-using the helper function, and output the result to the SortTimes.csv file
+
+/*Description: This function will register a case with the benchmark harness, which copies
+the array into arrayCopy before every trial, ensuring that every trial sorts the same
+unsorted input and the original array does not get modified. Only the sort on the copy is
+timed.
+Parameters: E *array: A pointer to the current array to be sorted
+int size: The size of the current array
+Benchmark &bench: The harness that times the case and keeps the result
+const string &name: The name of the case in the results
+Sort sort: Called with the copy and the size
+int threads: The number of threads the sort may use
+Return: N/A
+Notes: N/A */
+template <class E, class Sort>
+void logTimeCopy(E *array, int size, Benchmark &bench, const string &name, Sort sort, int threads) {
+    E *arrayCopy = new E[size];
+    bench.measure(name, size, sizeof(E), [&]() { std::copy(array, array + size, arrayCopy); },
+                  [&]() { sort(arrayCopy, size); }, threads);
+    delete[] arrayCopy; //freeing memory 
+}
+
+/*Description: This function will time the provided sorting algorithm on fresh copies of
+the array.
 Parameters: int *array: A pointer to the current array to be sorted
-const int size: The size of the current array
-ofstream &outfile: The output file for the result to be written to
+int size: The size of the current array
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
 sortPtr sort: A function pointer pointing to the sort algorithm to be ran
 Return: N/A
 Notes: N/A */
-void logTime(int *array, const int size, ofstream &outfile, sortPtr sort) {
-    //Make a copy of the current, unsorted array for the algorithm to sort
-    int *arrayCopy = new int[size]; 
-    for(int i = 0; i < size; i++) {
-        arrayCopy[i] = array[i];
-    }
-
-    //Time the sort using the new array copy
-    chrono::time_point<std::chrono::high_resolution_clock> start = startTimer();
-    sort(arrayCopy, size);
-    auto timeElasped = endTimer(start);
-    outfile << static_cast<double>(timeElasped/1000000) << ",";
-    
-    delete[] arrayCopy; //freeing memory 
+void logTime(int *array, int size, Benchmark &bench, const string &name, sortPtr sort) {
+    logTimeCopy(array, size, bench, name, sort);
 }
 
-/*Description: This function will create a new array copy called arrayCopy, ensuring
-that the original array does not get modified. It will then start the chronos timer, calling
-the startTimer helper funciton, then will run radix sort, end the timer 
-using the helper function, and output the result to the SortTimes.csv file
+/*Description: This function will time radix sort with the given radix on fresh copies of
+the array.
 Parameters: int *array: A pointer to the current array to be sorted
 int size: The size of the current array
-ofstream &outfile: The output file for the result to be written to
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
 int radix: The current radix to pass through the radixSort function
 Return: N/A
 Notes: N/A */
-void logTimeRadix(int *array, int size, ofstream &outfile, int radix) {
-     //Make a copy of the current, unsorted array for the algorithm to sort
+void logTimeRadix(int *array, int size, Benchmark &bench, const string &name, int radix) {
+    logTimeCopy(array, size, bench, name, [=](int *arrayCopy, int n) { radixsort(arrayCopy, n, radix); });
+}
+
+/*Description: This function will time the Algorithm Library's Sorting function on fresh
+copies of the array.
+Parameters: int *array: A pointer to the current array to be sorted
+int size: The size of the current array
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+Return: N/A
+Notes: N/A */
+void logTimeAlgSort(int *array, int size, Benchmark &bench, const string &name) {
+    logTimeCopy(array, size, bench, name, [](int *arrayCopy, int n) { std::sort(arrayCopy, arrayCopy + n); });
+}
+
+/*Description: This function will time the Count sorting algorithm on fresh copies of the
+array, with a fresh array of int positions as the payload when one is sorted along.
+Parameters: int *array: A pointer to the current array to be sorted
+int size: The size of the current array
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+int threads: The number of threads the count sort may use
+bool payload: Sort an array of int positions along with the keys (countsortByKey)
+Return: N/A
+Notes: Key ranges too wide to count are radix sorted by countsort itself */
+void logTimeCount(int *array, int size, Benchmark &bench, const string &name, int threads, bool payload) {
     int *arrayCopy = new int[size]; 
-    for(int i = 0; i < size; i++) {
-        arrayCopy[i] = array[i];
-    }
+    int *values = new int[size];
+    long lsize = static_cast<long>(size);
+    bench.measure(name, size, payload ? 2 * sizeof(int) : sizeof(int),
+        [&]() {
+            for(int i = 0; i < size; i++) {
+                arrayCopy[i] = array[i];
+                values[i] = i;
+            }
+        },
+        [&]() {
+            if(payload) {
+                countsortByKey(arrayCopy, values, lsize, threads);
+            }
+            else {
+                countsort(arrayCopy, lsize, threads);
+            }
+        }, threads);
 
-    //Time the sort using the new array copy
-    chrono::time_point<std::chrono::high_resolution_clock> start = startTimer();
-    radixsort(arrayCopy, size, radix);
-    auto timeElasped = endTimer(start);
-    outfile << static_cast<double>(timeElasped/1000000) << ",";
     delete[] arrayCopy; //freeing memory 
+    delete[] values;
 }
 
-/*Description: This function will create a new array copy called arrayCopy, ensuring
-that the original array does not get modified. It will then start the chronos timer, calling
-the startTimer helper funciton, then will run the Algorith's Library Sorting function,
-end the timer using the helper function, and output the result to the SortTimes.csv file
-Parameters: int *array: A pointer to the current array to be sorted
+/*Description: This function will time the Bucket Sorting algorithm on fresh copies of the
+array.
+Parameters: float *array: A pointer to the current array to be sorted
 int size: The size of the current array
-ofstream &outfile: The output file for the result to be written to
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+int threads: The number of threads the bucket sort may use
 Return: N/A
 Notes: N/A */
-void logTimeAlgSort(int *array, int size, ofstream &outfile) {
-     //Make a copy of the current, unsorted array for the algorithm to sort
-    int *arrayCopy = new int[size]; 
-    for(int i = 0; i < size; i++) {
-        arrayCopy[i] = array[i];
-    }
+void logTimeBucket(float *array, int size, Benchmark &bench, const string &name, int threads) {
+    logTimeCopy(array, size, bench, name,
+                [=](float *arrayCopy, int n) { BucketSort(arrayCopy, static_cast<long>(n), threads); }, threads);
+}
+
+/*Description: This function will time the chosen float sort on fresh copies of the array.
+Parameters: float *array: A pointer to the current array to be sorted
+int size: The size of the current array
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+int variant: 0 runs BucketSort, 1 runs floatRadixSort and 2 runs std::sort
+Return: N/A
+Notes: N/A */
+void logTimeFloat(float *array, int size, Benchmark &bench, const string &name, int variant) {
+    logTimeCopy(array, size, bench, name, [=](float *arrayCopy, int n) {
+        if(variant == 0) {
+            BucketSort(arrayCopy, static_cast<long>(n));
+        }
+        else if(variant == 1) {
+            floatRadixSort(arrayCopy, static_cast<long>(n));
+        }
+        else {
+            std::sort(arrayCopy, arrayCopy + n);
+        }
+    });
+}
 
-    //Time the sort using the new array copy
-    chrono::time_point<std::chrono::high_resolution_clock> start = startTimer();
-    std::sort(arrayCopy, arrayCopy+size);
-    auto timeElasped = endTimer(start);
-    outfile << static_cast<double>(timeElasped/1000000) << ",";
+/*Description: This function will time the parallel merge sort with the given number of
+threads on fresh copies of the array.
+Parameters: int *array: A pointer to the current array to be sorted
+int size: The size of the current array
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+int threads: The number of threads the merge sort may use
+Return: N/A
+Notes: N/A */
+void logTimeParallel(int *array, int size, Benchmark &bench, const string &name, int threads) {
+    logTimeCopy(array, size, bench, name,
+                [=](int *arrayCopy, int n) { mergeSort(arrayCopy, n, threads); }, threads);
+}
 
-    delete[] arrayCopy; //freeing memory 
+/*Description: This function will time the bottom-up merge sort on fresh copies of the
+array while passing the same scratch buffer to every trial.
+Parameters: int *array: A pointer to the current array to be sorted
+int size: The size of the current array
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+Return: N/A
+Notes: Shows the cost of the sort without the scratch allocation */
+void logTimeMergeScratch(int *array, int size, Benchmark &bench, const string &name) {
+    int *scratch = new int[size];
+    logTimeCopy(array, size, bench, name,
+                [=](int *arrayCopy, int n) { bottomUpMergeSort(arrayCopy, n, scratch); });
+    delete[] scratch; //freeing memory 
 }
 
-/*Description: This function will create a new array copy called arrayCopy, ensuring
-that the original array does not get modified. It will then start the chronos timer, calling
-the startTimer helper funciton, then will run the Count sorting algorithm, end the timer 
-using the helper function, and output the result to the SortTimes.csv file
+/*Description: This function will time the parallel sample sort with the given number of
+threads on fresh copies of the array.
 Parameters: int *array: A pointer to the current array to be sorted
 int size: The size of the current array
-ofstram &outfile: The output file for the result to be written to
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+int threads: The number of threads the sample sort may use
 Return: N/A
 Notes: N/A */
-void logTimeCount(int *array, int size, ofstream &outfile) {
-     //Make a copy of the current, unsorted array for the algorithm to sort
-    int *arrayCopy = new int[size]; 
-    for(int i = 0; i < size; i++) {
-        arrayCopy[i] = array[i];
+void logTimeSample(int *array, int size, Benchmark &bench, const string &name, int threads) {
+    logTimeCopy(array, size, bench, name,
+                [=](int *arrayCopy, int n) { sampleSort(arrayCopy, n, threads); }, threads);
+}
+
+/*Description: This function will time selecting the k smallest entries with the given
+variant on fresh copies of the array.
+Parameters: int *array: A pointer to the current array to be searched
+int size: The size of the current array
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+int k: The number of smallest entries to select
+int variant: 0 runs nthElement, 1 runs partialSort, 2 feeds a TopK 4096 entries at a time
+and 3 runs the parallel topK
+int threads: The number of threads the parallel top-k may use
+Return: N/A
+Notes: The top-k variants leave the copy unmodified, but copy it anyway so every variant
+starts from the same array */
+void logTimeSelect(int *array, int size, Benchmark &bench, const string &name, int k, int variant,
+                   int threads) {
+    logTimeCopy(array, size, bench, name, [=](int *arrayCopy, int n) {
+        if(variant == 0) {
+            nthElement(arrayCopy, n, k - 1);
+        }
+        else if(variant == 1) {
+            partialSort(arrayCopy, n, k);
+        }
+        else if(variant == 2) {
+            TopK<int> best(k);
+            for(int i = 0; i < n; i += 4096) {
+                best.add(arrayCopy + i, min(4096, n - i));
+            }
+            best.result();
+        }
+        else {
+            topK(arrayCopy, n, k, threads);
+        }
+    }, variant == 3 ? threads : 1);
+}
+
+/*Description: This function will cut a copy of the array into the given number of
+shards and sort each one, so the timed part only combines already-sorted shards, then
+time combining the shards with the given variant on fresh copies of the sorted shards.
+Parameters: int *array: A pointer to the current array to be split into shards
+int size: The size of the current array
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+int shards: The number of sorted shards
+int variant: 0 merge sorts the concatenated shards and 1 runs multiwayMerge
+int threads: The number of threads the multiway merge may use
+Return: N/A
+Notes: The shards already sit back to back, so the concatenation itself is not timed */
+void logTimeShards(int *array, int size, Benchmark &bench, const string &name, int shards, int variant,
+                   int threads) {
+    //Sort every shard of a copy of the current, unsorted array
+    int *sharded = new int[size];
+    int *arrayCopy = new int[size];
+    int *merged = new int[size];
+    vector<SortedRun<int>> runs;
+    for(int s = 0; s < shards; s++) {
+        int first = static_cast<long long>(size) * s / shards;
+        int last = static_cast<long long>(size) * (s + 1) / shards;
+        std::copy(array + first, array + last, sharded + first);
+        std::sort(sharded + first, sharded + last);
+        runs.push_back({arrayCopy + first, last - first});
     }
 
-    //Time the sort using the new array copy
-    chrono::time_point<std::chrono::high_resolution_clock> start = startTimer();
-    long lsize = static_cast<long>(size);
-    countsort(arrayCopy, lsize);
-    auto timeElasped = endTimer(start);
-    outfile << static_cast<double>(timeElasped/1000000) << ",";
+    bench.measure(name, size, sizeof(int), [&]() { std::copy(sharded, sharded + size, arrayCopy); },
+        [&]() {
+            if(variant == 0) {
+                mergeSort(arrayCopy, size);
+            }
+            else {
+                multiwayMerge(runs, merged, threads);
+            }
+        }, threads);
 
-    delete[] arrayCopy; //freeing memory 
+    delete[] sharded; //freeing memory
+    delete[] arrayCopy;
+    delete[] merged;
 }
 
-/*Description: This function will create a new array copy called arrayCopy, ensuring
-that the original array does not get modified. It will then start the chronos timer, calling
-the startTimer helper funciton, then will run the Bucket Sorting algorithm, end the timer 
-using the helper function, and output the result to the SortTimes.csv file
-Parameters: float *array: A pointer to the current array to be sorted
+/*Description: This function will build 64 byte records keyed by the array entries, both
+as an array of structs and as a key array next to a payload array, before every trial, and
+time sorting the records by key with the given variant.
+Parameters: int *array: A pointer to the keys of the records
 int size: The size of the current array
-ofstram &outfile: The output file for the result to be written to
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+int variant: 0 sorts the structs with the intro sort; 1, 2 and 3 sort the key and payload
+arrays with mergeSortByKey, quickSortByKey and radixSortByKey
 Return: N/A
-Notes: N/A */
-void logTimeBucket(float *array, int size, ofstream &outfile) {
-     //Make a copy of the current, unsorted array for the algorithm to sort
-    int *arrayCopy = new int[size]; 
-    for(int i = 0; i < size; i++) {
-        arrayCopy[i] = array[i];
+Notes: The key-value sorts only move the keys and int positions, and gather the payloads once */
+void logTimeRecords(int *array, int size, Benchmark &bench, const string &name, int variant) {
+    FatRecord *records = new FatRecord[size];
+    int *keys = new int[size];
+    Payload *payloads = new Payload[size];
+
+    //Make the records from the current, unsorted array for every trial
+    bench.measure(name, size, sizeof(FatRecord),
+        [&]() {
+            for(int i = 0; i < size; i++) {
+                records[i].key = keys[i] = array[i];
+                records[i].payload.bytes[0] = payloads[i].bytes[0] = static_cast<char>(i);
+            }
+        },
+        [&]() {
+            if(variant == 0) {
+                introSort(records, size);
+            }
+            else if(variant == 1) {
+                mergeSortByKey(keys, payloads, size);
+            }
+            else if(variant == 2) {
+                quickSortByKey(keys, payloads, size);
+            }
+            else {
+                radixSortByKey(keys, payloads, size);
+            }
+        });
+
+    delete[] records; //freeing memory 
+    delete[] keys;
+    delete[] payloads;
+}
+
+/*Description: This function will time sorting every block of "width" elements with the
+SIMD sorting network (insertion sort when the CPU has no kernel) on fresh copies of the
+array.
+Parameters: int *array: A pointer to the current array to be sorted
+int size: The size of the current array
+Benchmark &bench: The harness that times the case
+const string &name: The name of the case in the results
+int width: The block size handed to the network
+Return: N/A
+Notes: Only each block ends up sorted, not the whole array */
+void logTimeNetwork(int *array, int size, Benchmark &bench, const string &name, int width) {
+    logTimeCopy(array, size, bench, name, [=](int *arrayCopy, int n) {
+        for(int i = 0; i < n; i += width) {
+            smallSort(arrayCopy + i, min(width, n - i));
+        }
+    });
+}
+
+/*Description: This function will generate an array of the key type from every input
+distribution in "Distributions.h", and time every sort in Sorts.h that takes the key type
+on fresh copies of it: the comparison sorts and the library sort for every type, the LSD,
+MSD and count sorts for integers, the float radix and bucket sorts for floating point,
+and the MSD radix sort for strings. The generic front end is timed with the default
+ordering, which may dispatch to a radix sort or network, and with a lambda comparator,
+which always takes the comparison sort.
+Parameters: int size: The size of the arrays
+Benchmark &bench: The harness that times the cases
+const string &typeName: The name of the key type in the case names
+int threads: The number of threads the sample sort may use
+Return: N/A
+Notes: The quadratic bubble, insertion and selection sorts are left out. Every array is
+generated on all the threads, which gives the same keys as generating it on one */
+template <class T>
+void logTimeDistributions(int size, Benchmark &bench, const string &typeName, int threads) {
+    T *array = new T[size];
+    for(int d = 0; d < DIST_COUNT; d++) {
+        Distribution dist = static_cast<Distribution>(d);
+        if constexpr (is_same<T, string>::value) {
+            generateStrings(array, size, dist, nextInputSeed(), threads);
+        }
+        else {
+            generate(array, size, dist, nextInputSeed(), threads);
+        }
+        string input = string(" (") + distributionName(dist) + " " + typeName + ")";
+        logTimeCopy(array, size, bench, "Merge Sort" + input, [](T *a, int n) { mergeSort(a, n); });
+        logTimeCopy(array, size, bench, "Quick Sort" + input, [](T *a, int n) { quickSort(a, n); });
+        logTimeCopy(array, size, bench, "Intro Sort" + input, [](T *a, int n) { introSort(a, n); });
+        logTimeCopy(array, size, bench, "PDQ Sort" + input, [](T *a, int n) { pdqSort(a, n); });
+        logTimeCopy(array, size, bench, "Three-Way Quick Sort" + input,
+                    [](T *a, int n) { threeWayQuickSort(a, n); });
+        logTimeCopy(array, size, bench, "Dual-Pivot Quick Sort" + input,
+                    [](T *a, int n) { dualPivotQuickSort(a, n); });
+        logTimeCopy(array, size, bench, "Tim Sort" + input, [](T *a, int n) { timSort(a, n); });
+        logTimeCopy(array, size, bench, "In-Place Merge Sort" + input,
+                    [](T *a, int n) { inPlaceMergeSort(a, n); });
+        logTimeCopy(array, size, bench, "Comb Sort" + input, [](T *a, int n) { combsort(a, n); });
+        logTimeCopy(array, size, bench, "Shell Sort" + input, [](T *a, int n) { Shellsort(a, n); });
+        logTimeCopy(array, size, bench, "Heap Sort" + input, [](T *a, int n) { heapsort(a, n); });
+        logTimeCopy(array, size, bench, "Sample Sort (" + to_string(threads) + " Threads)" + input,
+                    [=](T *a, int n) { sampleSort(a, n, threads); }, threads);
+        logTimeCopy(array, size, bench, "Algorithm Library Sort" + input,
+                    [](T *a, int n) { std::sort(a, a + n); });
+        logTimeCopy(array, size, bench, "Generic Sort" + input, [](T *a, int n) { genericSort(a, a + n); });
+        logTimeCopy(array, size, bench, "Generic Sort (Lambda Comparator)" + input,
+                    [](T *a, int n) { genericSort(a, a + n, [](const T &x, const T &y) { return x < y; }); });
+        if constexpr (is_integral<T>::value) {
+            logTimeCopy(array, size, bench, "Radix Sort (Radix=256)" + input,
+                        [](T *a, int n) { radixsort(a, n, 256); });
+            logTimeCopy(array, size, bench, "Count Sort" + input, [](T *a, int n) { countsort(a, static_cast<long>(n)); });
+        }
+        if constexpr (is_integral<T>::value || is_same<T, string>::value) {
+            logTimeCopy(array, size, bench, "MSD Radix Sort" + input,
+                        [](T *a, int n) { msdRadixSort(a, static_cast<long>(n)); });
+        }
+        if constexpr (is_floating_point<T>::value) {
+            logTimeCopy(array, size, bench, "Float Radix Sort" + input,
+                        [](T *a, int n) { floatRadixSort(a, static_cast<long>(n)); });
+            logTimeCopy(array, size, bench, "Bucket Sort" + input,
+                        [](T *a, int n) { BucketSort(a, static_cast<long>(n)); });
+        }
     }
+    delete[] array; //freeing memory
+}
 
-    //Time the sort using the new array copy
-    long lsize = static_cast<long>(size);
-    chrono::time_point<std::chrono::high_resolution_clock> start = startTimer();
-    BucketSort(arrayCopy, lsize);
-    auto timeElasped = endTimer(start);
-    outfile << static_cast<double>(timeElasped/1000000) << ",";
+/*Description: Replacement for the global operator new that reports every allocation to the
+benchmark harness, so the peak heap memory of each sort can be logged. The size of the
+block is kept in a header in front of it for operator delete.
+Parameters: size_t bytes: The number of bytes requested
+Return: void pointer: The allocated block
+Notes: The array, nothrow and sized forms of new and delete all end up in these two. */
+void *operator new(size_t bytes) {
+    void *block = malloc(bytes + alignof(max_align_t));
+    if(block == nullptr) {
+        throw bad_alloc();
+    }
+    *static_cast<size_t *>(block) = bytes;
+    heapAllocated(bytes);
+    return static_cast<char *>(block) + alignof(max_align_t);
+}
 
-    delete[] arrayCopy; //freeing memory 
+/*Description: Replacement for the global operator delete that reports the freed block to
+the benchmark harness.
+Parameters: void *pointer: A block from operator new, or nullptr
+Return: N/A
+Notes: N/A */
+void operator delete(void *pointer) noexcept {
+    if(pointer == nullptr) {
+        return;
+    }
+    void *block = static_cast<char *>(pointer) - alignof(max_align_t);
+    heapFreed(*static_cast<size_t *>(block));
+    free(block);
 }
@@ -0,0 +1,694 @@
+/*
+Author: JJ McCauley
+Creation Date: 10/17/26
+Last Update: 10/17/26
+Description: SIMD bitonic sorting networks for small blocks of int, float and
+double keys, used as the base case of the sorts in Sorts.h, and an AVX2
+partition for int and float keys used by quickSort.
+Notes: Blocks of 8, 16, 32 or 64 keys are held in AVX2 (or SSE4.1) registers
+and sorted with a bitonic network of vector min/max operations. Compare-
+exchanges between registers are a plain min/max; compare-exchanges inside a
+register pair every lane with its partner through a lane permute and pick the
+min or max per lane with a blend. The instruction set is picked at run time
+with CPUID, so the program still runs on machines without AVX2. NaN keys are
+not supported by the float and double networks.
+The comb sort gap pass compare-exchanges a register of keys with the register
+gap positions further on using one min and one max, for gaps of at least a
+register width, where the lanes never depend on each other.
+The partition compares eight keys against the pivot at once, turns the
+comparison into an 8-bit mask, and uses the mask to look up a lane permutation
+that packs the keys going left in front of the keys going right. The packed
+register is stored at both write fronts, so no branch depends on the data.
+*/
+
+#ifndef SORTINGNETWORKS_H_
+#define SORTINGNETWORKS_H_
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SORTS_X86_SIMD
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Largest block the networks sort; larger ranges are left to the caller.
+const int NETWORK_MAX_BLOCK = 64;
+
+enum SimdLevel { SIMD_NONE, SIMD_SSE4, SIMD_AVX2 };
+
+/*
+Description: Detects the widest instruction set the networks can use.
+Parameters: None
+Return: SimdLevel of the running CPU, detected once per program.
+*/
+inline SimdLevel simdLevel() {
+#ifdef SORTS_X86_SIMD
+  static const SimdLevel level =
+      __builtin_cpu_supports("avx2")     ? SIMD_AVX2
+      : __builtin_cpu_supports("sse4.1") ? SIMD_SSE4
+                                         : SIMD_NONE;
+  return level;
+#else
+  return SIMD_NONE;
+#endif
+}
+
+// Key types with network kernels.
+template <class T>
+struct hasSortingNetwork
+    : integral_constant<bool, is_same<T, int>::value ||
+                                  is_same<T, float>::value ||
+                                  is_same<T, double>::value> {};
+
+#ifdef SORTS_X86_SIMD
+
+/*
+The bitonic network is written once against a register "traits" type V that
+supplies load, store, min, max, permXor<D> (swap lanes at distance D),
+blend<M> (take b in the lanes set in M) and reverse. Functions only get AVX2
+or SSE4.1 code generation when they are defined under the matching target
+pragma, so the network is stamped out inside each instruction set's region by
+this macro.
+
+Block element e is sorted ascending in stage S when (e & S) == 0, which makes
+every stage produce bitonic sequences for the next one and the last stage
+(S == N) sort the whole block ascending.
+*/
+#define SORTS_BITONIC_NETWORK                                                  \
+  template <class V, int N> struct BitonicNetwork {                           \
+    typedef typename V::reg reg;                                               \
+    static const int W = V::W;                                                 \
+    static const int R = N / W;                                                \
+                                                                               \
+    static constexpr int maxLanes(int S, int D, bool fixed, bool up) {         \
+      int mask = 0;                                                            \
+      for (int lane = 0; lane < W; lane++) {                                   \
+        bool ascending = fixed ? up : (lane & S) == 0;                         \
+        if (((lane & D) != 0) == ascending)                                    \
+          mask |= 1 << lane;                                                   \
+      }                                                                        \
+      return mask;                                                             \
+    }                                                                          \
+                                                                               \
+    template <int S, int D> static void step(reg r[]) {                        \
+      if constexpr (D >= W) {                                                  \
+        const int J = D / W;                                                   \
+        for (int i = 0; i < R; i++)                                            \
+          if ((i & J) == 0) {                                                  \
+            reg lo = V::min(r[i], r[i + J]);                                   \
+            reg hi = V::max(r[i], r[i + J]);                                   \
+            bool ascending = ((i * W) & S) == 0;                               \
+            r[i] = ascending ? lo : hi;                                        \
+            r[i + J] = ascending ? hi : lo;                                    \
+          }                                                                    \
+      } else {                                                                 \
+        for (int i = 0; i < R; i++) {                                          \
+          reg partner = V::template permXor<D>(r[i]);                          \
+          reg lo = V::min(r[i], partner);                                      \
+          reg hi = V::max(r[i], partner);                                      \
+          if constexpr (S < W)                                                 \
+            r[i] = V::template blend<maxLanes(S, D, false, true)>(lo, hi);     \
+          else if (((i * W) & S) == 0)                                         \
+            r[i] = V::template blend<maxLanes(S, D, true, true)>(lo, hi);      \
+          else                                                                 \
+            r[i] = V::template blend<maxLanes(S, D, true, false)>(lo, hi);     \
+        }                                                                      \
+      }                                                                        \
+    }                                                                          \
+                                                                               \
+    template <int S, int D> static void merge(reg r[]) {                       \
+      step<S, D>(r);                                                           \
+      if constexpr (D > 1)                                                     \
+        merge<S, D / 2>(r);                                                    \
+    }                                                                          \
+                                                                               \
+    template <int S> static void sortStages(reg r[]) {                         \
+      merge<S, S / 2>(r);                                                      \
+      if constexpr (S < N)                                                     \
+        sortStages<S * 2>(r);                                                  \
+    }                                                                          \
+                                                                               \
+    static void sort(typename V::key A[]) {                                    \
+      reg r[R];                                                                \
+      for (int i = 0; i < R; i++)                                              \
+        r[i] = V::load(A + i * W);                                             \
+      sortStages<2>(r);                                                        \
+      for (int i = 0; i < R; i++)                                              \
+        V::store(A + i * W, r[i]);                                             \
+    }                                                                          \
+                                                                               \
+    static void mergeRegisters(reg &a, reg &b) {                               \
+      b = V::reverse(b);                                                       \
+      reg lo = V::min(a, b);                                                   \
+      reg hi = V::max(a, b);                                                   \
+      BitonicNetwork<V, W>::template merge<W, W / 2>(&lo);                     \
+      BitonicNetwork<V, W>::template merge<W, W / 2>(&hi);                     \
+      a = lo;                                                                  \
+      b = hi;                                                                  \
+    }                                                                          \
+  };                                                                           \
+                                                                               \
+  template <class V> void sortBlock(typename V::key A[], int n) {              \
+    switch (n) {                                                               \
+    case 8:                                                                    \
+      BitonicNetwork<V, 8>::sort(A);                                           \
+      break;                                                                   \
+    case 16:                                                                   \
+      BitonicNetwork<V, 16>::sort(A);                                          \
+      break;                                                                   \
+    case 32:                                                                   \
+      BitonicNetwork<V, 32>::sort(A);                                          \
+      break;                                                                   \
+    default:                                                                   \
+      BitonicNetwork<V, 64>::sort(A);                                          \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  template <class V>                                                           \
+  void mergeBlocks(typename V::key A[], typename V::key B[]) {                 \
+    typename V::reg a = V::load(A);                                            \
+    typename V::reg b = V::load(B);                                            \
+    BitonicNetwork<V, 2 * V::W>::mergeRegisters(a, b);                         \
+    V::store(A, a);                                                            \
+    V::store(B, b);                                                            \
+  }
+
+/*
+Compare-exchange of every key with the key gap positions later, from the
+front of the array to the back, stamped out per instruction set like the
+network above. With gap >= W no lane reads a key written by another lane of
+the same register, so the result is the same as the scalar loop.
+*/
+#define SORTS_GAP_PASS                                                         \
+  template <class V> void gapPass(typename V::key A[], int n, int gap) {       \
+    int i = 0;                                                                 \
+    for (; i + V::W <= n - gap; i += V::W) {                                   \
+      typename V::reg a = V::load(A + i);                                      \
+      typename V::reg b = V::load(A + i + gap);                                \
+      V::store(A + i, V::min(a, b));                                           \
+      V::store(A + i + gap, V::max(a, b));                                     \
+    }                                                                          \
+    for (; i < n - gap; i++)                                                   \
+      if (A[i + gap] < A[i])                                                   \
+        swap(A[i], A[i + gap]);                                                \
+  }
+
+///////////////////////////////////////////////////////////
+//  AVX2 kernels
+///////////////////////////////////////////////////////////
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace simd_avx2 {
+
+struct Int32x8 {
+  typedef int key;
+  typedef __m256i reg;
+  static const int W = 8;
+
+  static reg load(const int *p) { return _mm256_loadu_si256((const reg *)p); }
+  static void store(int *p, reg v) { _mm256_storeu_si256((reg *)p, v); }
+  static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+  static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+
+  template <int D> static reg permXor(reg v) {
+    if constexpr (D == 1)
+      return _mm256_shuffle_epi32(v, 0xB1);
+    else if constexpr (D == 2)
+      return _mm256_shuffle_epi32(v, 0x4E);
+    else
+      return _mm256_permute2x128_si256(v, v, 1);
+  }
+
+  template <int M> static reg blend(reg a, reg b) {
+    return _mm256_blend_epi32(a, b, M);
+  }
+
+  static reg reverse(reg v) {
+    return _mm256_permutevar8x32_epi32(
+        v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+  }
+
+  static reg set1(int x) { return _mm256_set1_epi32(x); }
+
+  static reg permute(reg v, const int *lanes) {
+    return _mm256_permutevar8x32_epi32(v,
+                                       _mm256_load_si256((const reg *)lanes));
+  }
+
+  // Lanes of v that belong right of the pivot p.
+  template <bool EqualRight> static int rightMask(reg v, reg p) {
+    if constexpr (EqualRight)
+      return ~_mm256_movemask_ps(
+                 _mm256_castsi256_ps(_mm256_cmpgt_epi32(p, v))) &
+             0xFF;
+    else
+      return _mm256_movemask_ps(
+          _mm256_castsi256_ps(_mm256_cmpgt_epi32(v, p)));
+  }
+};
+
+struct Float8 {
+  typedef float key;
+  typedef __m256 reg;
+  static const int W = 8;
+
+  static reg load(const float *p) { return _mm256_loadu_ps(p); }
+  static void store(float *p, reg v) { _mm256_storeu_ps(p, v); }
+  static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+  static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+
+  template <int D> static reg permXor(reg v) {
+    if constexpr (D == 1)
+      return _mm256_permute_ps(v, 0xB1);
+    else if constexpr (D == 2)
+      return _mm256_permute_ps(v, 0x4E);
+    else
+      return _mm256_permute2f128_ps(v, v, 1);
+  }
+
+  template <int M> static reg blend(reg a, reg b) {
+    return _mm256_blend_ps(a, b, M);
+  }
+
+  static reg reverse(reg v) {
+    return _mm256_permutevar8x32_ps(
+        v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+  }
+
+  static reg set1(float x) { return _mm256_set1_ps(x); }
+
+  static reg permute(reg v, const int *lanes) {
+    return _mm256_permutevar8x32_ps(
+        v, _mm256_load_si256((const __m256i *)lanes));
+  }
+
+  // Lanes of v that belong right of the pivot p.
+  template <bool EqualRight> static int rightMask(reg v, reg p) {
+    if constexpr (EqualRight)
+      return _mm256_movemask_ps(_mm256_cmp_ps(v, p, _CMP_GE_OQ));
+    else
+      return _mm256_movemask_ps(_mm256_cmp_ps(v, p, _CMP_GT_OQ));
+  }
+};
+
+struct Double4 {
+  typedef double key;
+  typedef __m256d reg;
+  static const int W = 4;
+
+  static reg load(const double *p) { return _mm256_loadu_pd(p); }
+  static void store(double *p, reg v) { _mm256_storeu_pd(p, v); }
+  static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+  static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+
+  template <int D> static reg permXor(reg v) {
+    if constexpr (D == 1)
+      return _mm256_permute_pd(v, 0x5);
+    else
+      return _mm256_permute2f128_pd(v, v, 1);
+  }
+
+  template <int M> static reg blend(reg a, reg b) {
+    return _mm256_blend_pd(a, b, M);
+  }
+
+  static reg reverse(reg v) { return _mm256_permute4x64_pd(v, 0x1B); }
+};
+
+SORTS_BITONIC_NETWORK
+SORTS_GAP_PASS
+
+inline void sortBlock(int A[], int n) { sortBlock<Int32x8>(A, n); }
+inline void sortBlock(float A[], int n) { sortBlock<Float8>(A, n); }
+inline void sortBlock(double A[], int n) { sortBlock<Double4>(A, n); }
+
+// For every 8-bit mask, the lanes outside the mask in order followed by the
+// lanes inside it.
+struct PartitionTable {
+  alignas(32) int lanes[256][8];
+
+  PartitionTable() {
+    for (int mask = 0; mask < 256; mask++) {
+      int k = 0;
+      for (int lane = 0; lane < 8; lane++)
+        if (!(mask & (1 << lane)))
+          lanes[mask][k++] = lane;
+      for (int lane = 0; lane < 8; lane++)
+        if (mask & (1 << lane))
+          lanes[mask][k++] = lane;
+    }
+  }
+};
+
+inline const PartitionTable &partitionTable() {
+  static const PartitionTable table;
+  return table;
+}
+
+/*
+Description: In-place partition of 8-lane keys. The first and last registers
+are loaded up front, which leaves a free gap of 16 slots; each step then
+loads the next register from whichever end has less free space, so both
+write fronts always have a full register of room.
+Parameters: Array A, size of the array and pivot value.
+Return: Number of keys that went left. With EqualRight those are the keys
+less than the pivot, otherwise the keys less than or equal to it.
+*/
+template <class V, bool EqualRight>
+int partition(typename V::key A[], int n, typename V::key pivot) {
+  typedef typename V::key key;
+  typedef typename V::reg reg;
+  const int W = V::W;
+  const PartitionTable &table = partitionTable();
+
+  int writeL = 0;
+  int writeR = n;
+  if (n < 2 * W) {
+    key rest[2 * W];
+    copy(A, A + n, rest);
+    for (int i = 0; i < n; i++)
+      if (EqualRight ? !(rest[i] < pivot) : pivot < rest[i])
+        A[--writeR] = rest[i];
+      else
+        A[writeL++] = rest[i];
+    return writeL;
+  }
+
+  reg p = V::set1(pivot);
+  reg first = V::load(A);
+  reg last = V::load(A + n - W);
+  int readL = W;
+  int readR = n - W;
+
+  auto storePartitioned = [&](reg v) {
+    int mask = V::template rightMask<EqualRight>(v, p);
+    reg packed = V::permute(v, table.lanes[mask]);
+    V::store(A + writeL, packed);
+    V::store(A + writeR - W, packed);
+    int right = __builtin_popcount(mask);
+    writeL += W - right;
+    writeR -= right;
+  };
+
+  while (readR - readL >= W) {
+    reg v;
+    if (readL - writeL <= writeR - readR) {
+      v = V::load(A + readL);
+      readL += W;
+    } else {
+      readR -= W;
+      v = V::load(A + readR);
+    }
+    storePartitioned(v);
+  }
+
+  key rest[W];
+  int restSize = readR - readL;
+  copy(A + readL, A + readR, rest);
+  for (int i = 0; i < restSize; i++)
+    if (EqualRight ? !(rest[i] < pivot) : pivot < rest[i])
+      A[--writeR] = rest[i];
+    else
+      A[writeL++] = rest[i];
+
+  storePartitioned(first);
+  storePartitioned(last);
+  return writeL;
+}
+
+} // namespace simd_avx2
+#pragma GCC pop_options
+
+///////////////////////////////////////////////////////////
+//  SSE4.1 kernels
+///////////////////////////////////////////////////////////
+
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+namespace simd_sse4 {
+
+struct Int32x4 {
+  typedef int key;
+  typedef __m128i reg;
+  static const int W = 4;
+
+  static reg load(const int *p) { return _mm_loadu_si128((const reg *)p); }
+  static void store(int *p, reg v) { _mm_storeu_si128((reg *)p, v); }
+  static reg min(reg a, reg b) { return _mm_min_epi32(a, b); }
+  static reg max(reg a, reg b) { return _mm_max_epi32(a, b); }
+
+  template <int D> static reg permXor(reg v) {
+    if constexpr (D == 1)
+      return _mm_shuffle_epi32(v, 0xB1);
+    else
+      return _mm_shuffle_epi32(v, 0x4E);
+  }
+
+  template <int M> static reg blend(reg a, reg b) {
+    return _mm_castps_si128(
+        _mm_blend_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), M));
+  }
+
+  static reg reverse(reg v) { return _mm_shuffle_epi32(v, 0x1B); }
+};
+
+struct Float4 {
+  typedef float key;
+  typedef __m128 reg;
+  static const int W = 4;
+
+  static reg load(const float *p) { return _mm_loadu_ps(p); }
+  static void store(float *p, reg v) { _mm_storeu_ps(p, v); }
+  static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+  static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+
+  template <int D> static reg permXor(reg v) {
+    if constexpr (D == 1)
+      return _mm_shuffle_ps(v, v, 0xB1);
+    else
+      return _mm_shuffle_ps(v, v, 0x4E);
+  }
+
+  template <int M> static reg blend(reg a, reg b) {
+    return _mm_blend_ps(a, b, M);
+  }
+
+  static reg reverse(reg v) { return _mm_shuffle_ps(v, v, 0x1B); }
+};
+
+struct Double2 {
+  typedef double key;
+  typedef __m128d reg;
+  static const int W = 2;
+
+  static reg load(const double *p) { return _mm_loadu_pd(p); }
+  static void store(double *p, reg v) { _mm_storeu_pd(p, v); }
+  static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+  static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+
+  template <int D> static reg permXor(reg v) {
+    return _mm_shuffle_pd(v, v, 1);
+  }
+
+  template <int M> static reg blend(reg a, reg b) {
+    return _mm_blend_pd(a, b, M);
+  }
+
+  static reg reverse(reg v) { return _mm_shuffle_pd(v, v, 1); }
+};
+
+SORTS_BITONIC_NETWORK
+SORTS_GAP_PASS
+
+inline void sortBlock(int A[], int n) { sortBlock<Int32x4>(A, n); }
+inline void sortBlock(float A[], int n) { sortBlock<Float4>(A, n); }
+inline void sortBlock(double A[], int n) { sortBlock<Double2>(A, n); }
+
+} // namespace simd_sse4
+#pragma GCC pop_options
+
+#undef SORTS_BITONIC_NETWORK
+#undef SORTS_GAP_PASS
+
+#endif /* SORTS_X86_SIMD */
+
+/*
+Description: Sorts a small array with the widest available network. The keys
+are padded up to the next block size of 8, 16, 32 or 64 with the largest
+value of the type, so the padding sorts to the end of the block.
+Parameters: Array A and size of the array.
+Return: True if a network sorted the array, false if T has no kernel, the
+array is larger than NETWORK_MAX_BLOCK, or the CPU has no usable SIMD.
+*/
+template <class T> bool networkSort(T A[], int size) {
+  if constexpr (!hasSortingNetwork<T>::value) {
+    return false;
+  } else {
+#ifdef SORTS_X86_SIMD
+    if (size > NETWORK_MAX_BLOCK)
+      return false;
+    if (size < 2)
+      return true;
+
+    SimdLevel level = simdLevel();
+    if (level == SIMD_NONE)
+      return false;
+
+    int block = 8;
+    while (block < size)
+      block *= 2;
+
+    T padded[NETWORK_MAX_BLOCK];
+    T *keys = A;
+    if (block != size) {
+      copy(A, A + size, padded);
+      fill(padded + size, padded + block,
+           numeric_limits<T>::has_infinity ? numeric_limits<T>::infinity()
+                                            : numeric_limits<T>::max());
+      keys = padded;
+    }
+
+    if (level == SIMD_AVX2)
+      simd_avx2::sortBlock(keys, block);
+    else
+      simd_sse4::sortBlock(keys, block);
+
+    if (keys != A)
+      copy(keys, keys + size, A);
+    return true;
+#else
+    return false;
+#endif
+  }
+}
+
+/*
+Description: Number of keys of type T held in one register of the widest
+available network, which is the run length networkMerge works on.
+Parameters: None
+Return: Keys per register, or 0 if no kernel is available.
+*/
+template <class T> int networkWidth() {
+  if (!hasSortingNetwork<T>::value)
+    return 0;
+
+  switch (simdLevel()) {
+  case SIMD_AVX2:
+    return 32 / sizeof(T);
+  case SIMD_SSE4:
+    return 16 / sizeof(T);
+  default:
+    return 0;
+  }
+}
+
+/*
+Description: Merges two sorted runs of networkWidth<T>() keys each with a
+vectorized bitonic merge of two registers. A receives the smaller half and B
+the larger half, both sorted.
+Parameters: The two sorted runs.
+Return: True if the runs were merged, false if no kernel is available.
+*/
+template <class T> bool networkMerge(T A[], T B[]) {
+  if constexpr (!hasSortingNetwork<T>::value) {
+    return false;
+  } else {
+#ifdef SORTS_X86_SIMD
+    SimdLevel level = simdLevel();
+    if (level == SIMD_AVX2) {
+      if constexpr (is_same<T, int>::value)
+        simd_avx2::mergeBlocks<simd_avx2::Int32x8>(A, B);
+      else if constexpr (is_same<T, float>::value)
+        simd_avx2::mergeBlocks<simd_avx2::Float8>(A, B);
+      else
+        simd_avx2::mergeBlocks<simd_avx2::Double4>(A, B);
+      return true;
+    }
+    if (level == SIMD_SSE4) {
+      if constexpr (is_same<T, int>::value)
+        simd_sse4::mergeBlocks<simd_sse4::Int32x4>(A, B);
+      else if constexpr (is_same<T, float>::value)
+        simd_sse4::mergeBlocks<simd_sse4::Float4>(A, B);
+      else
+        simd_sse4::mergeBlocks<simd_sse4::Double2>(A, B);
+      return true;
+    }
+#endif
+    return false;
+  }
+}
+
+/*
+Description: One comb sort pass: compare-exchanges A[i] and A[i + gap] for
+every i from the front of the array to the back, with vector min and max.
+Parameters: Array A, size of the array and the gap.
+Return: True if the pass was done, false if T has no kernel, the CPU has no
+usable SIMD, or the gap is less than networkWidth<T>().
+*/
+template <class T> bool simdGapPass(T A[], int n, int gap) {
+  if constexpr (!hasSortingNetwork<T>::value) {
+    return false;
+  } else {
+#ifdef SORTS_X86_SIMD
+    int width = networkWidth<T>();
+    if (width == 0 || gap < width)
+      return false;
+    if (simdLevel() == SIMD_AVX2) {
+      if constexpr (is_same<T, int>::value)
+        simd_avx2::gapPass<simd_avx2::Int32x8>(A, n, gap);
+      else if constexpr (is_same<T, float>::value)
+        simd_avx2::gapPass<simd_avx2::Float8>(A, n, gap);
+      else
+        simd_avx2::gapPass<simd_avx2::Double4>(A, n, gap);
+    } else {
+      if constexpr (is_same<T, int>::value)
+        simd_sse4::gapPass<simd_sse4::Int32x4>(A, n, gap);
+      else if constexpr (is_same<T, float>::value)
+        simd_sse4::gapPass<simd_sse4::Float4>(A, n, gap);
+      else
+        simd_sse4::gapPass<simd_sse4::Double2>(A, n, gap);
+    }
+    return true;
+#else
+    return false;
+#endif
+  }
+}
+
+// Key types with an AVX2 partition.
+template <class T>
+struct hasSimdPartition
+    : integral_constant<bool, is_same<T, int>::value ||
+                                  is_same<T, float>::value> {};
+
+/*
+Description: Partitions an int or float array around a pivot with the AVX2
+partition, moving keys less than the pivot (less than or equal when
+EqualRight is false) to the front.
+Parameters: Array A, size of the array and pivot value.
+Return: Number of keys moved to the front, or -1 if T has no kernel or the
+CPU has no AVX2.
+*/
+template <bool EqualRight, class T> int simdPartition(T A[], int n, T pivot) {
+  if constexpr (!hasSimdPartition<T>::value) {
+    return -1;
+  } else {
+#ifdef SORTS_X86_SIMD
+    if (simdLevel() != SIMD_AVX2)
+      return -1;
+    if constexpr (is_same<T, int>::value)
+      return simd_avx2::partition<simd_avx2::Int32x8, EqualRight>(A, n, pivot);
+    else
+      return simd_avx2::partition<simd_avx2::Float8, EqualRight>(A, n, pivot);
+#else
+    return -1;
+#endif
+  }
+}
+
+#endif /* SORTINGNETWORKS_H_ */
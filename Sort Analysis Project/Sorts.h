@@ -1,7 +1,7 @@
 /*
 Author: Don Spickler
 Creation Date: 1/15/2023
-Last Update: 1/25/2024
+Last Update: 10/17/26
 Description: Set of standard sorting routines.
 Notes: Algorithms and code were taken from either
 Data Structures and Algorithms in C++ by Adam Drozdek or
@@ -13,31 +13,99 @@ Modified slightly by JJ McCauley for compatibility
 #define SORTS_H_
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <deque>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "SortingNetworks.h"
+#include "ThreadPool.h"
+
 using namespace std;
 
 template <class T> bool sorted(T A[], int size);
 
 template <class T> void bubble(T A[], int size);
 template <class T> void insertion(T A[], int size);
+template <class T> void smallSort(T A[], int size);
 template <class T> void selection(T A[], int size);
 template <class T> void merge(T A[], T Temp[], int startA, int startB, int end);
 template <class T> void mergeSort(T A[], T Temp[], int start, int end);
 template <class T> void mergeSort(T A[], int size);
+template <class T> void mergeSort(T A[], int size, int threads);
+template <class T>
+void bottomUpMergeSort(T A[], int size, T Scratch[] = nullptr);
+template <class T> void inPlaceMergeSort(T A[], int size);
+template <class T>
+void inPlaceMergeSort(T A[], int size, T Buffer[], int bufferSize);
+template <class T> void timSort(T A[], int size, T Scratch[] = nullptr);
+template <class T> struct SortedRun;
+template <class T>
+void multiwayMerge(const vector<SortedRun<T>> &runs, T Out[], int threads = 1);
 template <class T> void quickSort(T A[], int left, int right);
 template <class T> void quickSort(T A[], int size);
+template <class T> void introSort(T A[], int size);
+template <class T> void blockQuickSort(T A[], int size);
+template <class T> void threeWayQuickSort(T A[], int size);
+template <class T> void dualPivotQuickSort(T A[], int size);
+template <class T> void pdqSort(T A[], int size);
+template <class T> void sampleSort(T A[], int size, int threads);
 template <class T> void combsort(T data[], const int n);
 template <class T> void Shellsort(T data[], int n);
+enum ShellGaps : int;
+template <class T> void Shellsort(T data[], int n, ShellGaps sequence);
 template <class T> void moveDown(T data[], int first, int last);
 template <class T> void heapsort(T data[], const int n);
-// T needs to be an integer type for radix and count.
+template <class T> void binaryHeapsort(T data[], const int n);
+template <int D, class T> void dAryHeapsort(T data[], const int n);
+template <class T> void nthElement(T A[], int size, int k);
+template <class T> void partialSort(T A[], int size, int k);
+template <class T>
+vector<T> topK(const T A[], int size, int k, int threads = 1);
+// T needs to be an integer type for count; radix also takes float and double.
 template <class T> void radixsort(T data[], const int n, const int radix);
-template <class T> void countsort(T A[], long sz);
+template <class T>
+void lsdRadixSort(T data[], long n, int digitBits, T scratch[] = nullptr);
+template <class T> void floatRadixSort(T A[], long n, int digitBits = 11);
+template <class T> void msdRadixSort(T A[], long n, int threads = 1);
+void msdRadixSort(string A[], long n, int threads = 1);
+template <class T> void countsort(T A[], long sz, int threads = 1);
+template <class K, class V>
+void countsortByKey(K keys[], V values[], long sz, int threads = 1);
 // T needs to be a float type for bucket.
-template <class T> void BucketSort(T A[], long sz);
+template <class T> void BucketSort(T A[], long sz, int threads = 1);
+// Keys and values are separate arrays; entry i of values travels with keys[i].
+template <class K, class V>
+void mergeSortByKey(K keys[], V values[], int n);
+template <class K, class V>
+void quickSortByKey(K keys[], V values[], int n);
+template <class K, class V>
+void radixSortByKey(K keys[], V values[], int n);
+template <class K, class V> void sortByKey(K keys[], V values[], int n);
+template <class K> vector<int> mergeArgsort(const K keys[], int n);
+template <class K> vector<int> quickArgsort(const K keys[], int n);
+template <class K> vector<int> radixArgsort(const K keys[], int n);
+template <class K> vector<int> argsort(const K keys[], int n);
+template <class T>
+void gather(const T source[], const int index[], T dest[], int n);
+// Generic front end: any comparator and projection, size_t lengths.
+struct Identity;
+struct SequentialPolicy;
+struct ParallelPolicy;
+template <class T, class Compare = less<>, class Project = Identity,
+          class Policy = SequentialPolicy>
+void genericSort(T *first, T *last, Compare comp = Compare(),
+                 Project proj = Project(), Policy policy = Policy());
 
 /*
 Description: Determines if the array is sorted.
@@ -85,6 +153,18 @@ template <class T> void insertion(T A[], int size) {
   }
 }
 
+/*
+Description: Leaf sort for the hybrid sorts. Uses a SIMD sorting network for
+int, float and double arrays of up to NETWORK_MAX_BLOCK entries and insertion
+sort otherwise.
+Parameters: Array A and size of the array.
+Return: None
+*/
+template <class T> void smallSort(T A[], int size) {
+  if (!networkSort(A, size))
+    insertion(A, size);
+}
+
 /*
 Description: Sorts the array using the standard selection sort.
 Parameters: Array A and size of the array.
@@ -123,7 +203,7 @@ void merge(T A[], T Temp[], int startA, int startB, int end) {
   int i = startA;
 
   while (aptr < startB && bptr <= end)
-    if (A[aptr] < A[bptr])
+    if (!(A[bptr] < A[aptr]))
       Temp[i++] = A[aptr++];
     else
       Temp[i++] = A[bptr++];
@@ -143,8 +223,15 @@ Description: Recursive subdividing portion of the merge sort algorithm.
 Parameters: Array A, temp array, starting and ending positions of the
 portion being subdivided.
 Return: None
+Notes: Small int portions are sorted by a SIMD network. Float and double
+portions are not, since the network is not stable and would reorder -0.0 and
++0.0 (and NaN keys), as in bottomUpMergeSort.
 */
 template <class T> void mergeSort(T A[], T Temp[], int start, int end) {
+  if (is_integral<T>::value && end - start < NETWORK_MAX_BLOCK &&
+      networkSort(A + start, end - start + 1))
+    return;
+
   if (start < end) {
     int mid = (start + end) / 2;
     mergeSort(A, Temp, start, mid);
@@ -157,256 +244,3473 @@ template <class T> void mergeSort(T A[], T Temp[], int start, int end) {
 Description: Non-recursive starting function for the merge sort.
 Parameters: Array A and size of the array.
 Return: None
+Notes: Runs the bottom-up merge sort below, which does not copy the merged
+ranges back into A at every level.
 */
 template <class T> void mergeSort(T A[], int size) {
-  T *Temp = new T[size];
-  mergeSort(A, Temp, 0, size - 1);
-  delete[] Temp;
+  bottomUpMergeSort(A, size);
 }
 
 ///////////////////////////////////////////////////////////
-//  Quick Sort
+//  Bottom-Up Merge Sort
 ///////////////////////////////////////////////////////////
 
+// Length of the runs sorted before the first merge pass.
+const int MERGE_RUN = 64;
+// Consecutive wins by one run before the merge starts galloping.
+const int MIN_GALLOP = 7;
+
 /*
-Description: Recursive subdividing portion of the quick sort algorithm.
-Parameters: Array A, starting and ending positions of the portion being
-subdivided.
-Return: None
+Description: Exponential search for the number of entries of a sorted array
+that are less than or equal to key (less than key for gallopLeft). Probes
+positions 1, 3, 7, 15, ... and then binary searches the last gap, so the cost
+grows with the log of the answer rather than the log of n.
+Parameters: Key, sorted array and its size.
+Return: Insertion position of key.
 */
-template <class T> void quickSort(T A[], int left, int right) {
-  int i = left;
-  int j = right;
-  int mid = (left + right) / 2;
+template <class T> int gallopRight(const T &key, const T A[], int n) {
+  if (n == 0 || key < A[0])
+    return 0;
 
-  T pivot = A[mid];
+  int lo = 0;
+  int hi = 1;
+  while (hi < n && !(key < A[hi])) {
+    lo = hi;
+    hi = 2 * hi + 1;
+  }
+  hi = min(hi, n);
+  return upper_bound(A + lo + 1, A + hi, key) - A;
+}
 
-  while (i <= j) {
-    while (A[i] < pivot)
-      i++;
+template <class T> int gallopLeft(const T &key, const T A[], int n) {
+  if (n == 0 || !(A[0] < key))
+    return 0;
 
-    while (A[j] > pivot)
-      j--;
+  int lo = 0;
+  int hi = 1;
+  while (hi < n && A[hi] < key) {
+    lo = hi;
+    hi = 2 * hi + 1;
+  }
+  hi = min(hi, n);
+  return lower_bound(A + lo + 1, A + hi, key) - A;
+}
 
-    if (i <= j) {
-      T tmp = A[i];
-      A[i] = A[j];
-      A[j] = tmp;
-      i++;
-      j--;
+/*
+Description: Stable merge of two sorted runs into an output array. Once one
+run has supplied MIN_GALLOP entries in a row, the rest of its winning streak
+is found with an exponential search and copied as a block, which makes
+lopsided merges (like TimSort's) close to linear in the smaller run.
+Parameters: First run and its length, second run and its length, and the
+output array.
+Return: None
+Notes: Out may overlap B when Out + sizeA == B, since entries of B are always
+read before their position is written.
+*/
+template <class T>
+void gallopMerge(const T A[], int sizeA, const T B[], int sizeB, T Out[]) {
+  int aptr = 0;
+  int bptr = 0;
+  int i = 0;
+
+  while (aptr < sizeA && bptr < sizeB) {
+    // one entry at a time until a run wins MIN_GALLOP times in a row
+    int winsA = 0;
+    int winsB = 0;
+    do {
+      if (B[bptr] < A[aptr]) {
+        Out[i++] = B[bptr++];
+        winsB++;
+        winsA = 0;
+        if (bptr == sizeB)
+          break;
+      } else {
+        Out[i++] = A[aptr++];
+        winsA++;
+        winsB = 0;
+        if (aptr == sizeA)
+          break;
+      }
+    } while ((winsA | winsB) < MIN_GALLOP);
+
+    if (aptr == sizeA || bptr == sizeB)
+      break;
+
+    int run;
+    if (winsA >= MIN_GALLOP) {
+      run = gallopRight(B[bptr], A + aptr, sizeA - aptr);
+      copy(A + aptr, A + aptr + run, Out + i);
+      aptr += run;
+    } else {
+      run = gallopLeft(A[aptr], B + bptr, sizeB - bptr);
+      copy(B + bptr, B + bptr + run, Out + i);
+      bptr += run;
     }
+    i += run;
   }
 
-  if (left < j)
-    quickSort(A, left, j);
+  while (aptr < sizeA)
+    Out[i++] = A[aptr++];
 
-  if (i < right)
-    quickSort(A, i, right);
+  while (bptr < sizeB)
+    Out[i++] = B[bptr++];
 }
 
 /*
-Description: Non-recursive starting function for the quick sort.
-Parameters: Array A and size of the array.
+Description: Iterative merge sort. Runs of MERGE_RUN entries are sorted
+first, then each pass merges pairs of runs from one buffer into the other and
+the two buffers swap roles, so nothing is copied back between passes.
+Parameters: Array A, size of the array, and an optional scratch buffer of
+at least size entries that can be reused across calls.
 Return: None
+Notes: The sort is stable. When the number of passes is odd the result is in
+the scratch buffer and is copied into A once at the end. Without a scratch
+buffer one is allocated for the call.
 */
-template <class T> void quickSort(T A[], int size) {
-  quickSort(A, 0, size - 1);
+template <class T> void bottomUpMergeSort(T A[], int size, T Scratch[]) {
+  if (size < 2)
+    return;
+
+  for (int start = 0; start < size; start += MERGE_RUN) {
+    int run = min(MERGE_RUN, size - start);
+    if (is_integral<T>::value)
+      smallSort(A + start, run);
+    else
+      insertion(A + start, run);
+  }
+
+  T *buffer = Scratch != nullptr ? Scratch : new T[size];
+  T *src = A;
+  T *dst = buffer;
+
+  for (int width = MERGE_RUN; width < size; width *= 2) {
+    for (int lo = 0; lo < size; lo += 2 * width) {
+      int mid = min(lo + width, size);
+      int hi = min(lo + 2 * width, size);
+      if (mid == hi || !(src[mid] < src[mid - 1]))
+        copy(src + lo, src + hi, dst + lo); // already in order
+      else
+        gallopMerge(src + lo, mid - lo, src + mid, hi - mid, dst + lo);
+    }
+    swap(src, dst);
+  }
+
+  if (src != A)
+    copy(src, src + size, A);
+
+  if (Scratch == nullptr)
+    delete[] buffer;
 }
 
 ///////////////////////////////////////////////////////////
-//  Comb Sort
+//  In-Place Merge Sort: stable with a small or no buffer
 ///////////////////////////////////////////////////////////
 
 /*
-Description: Sorts the array using the standard comb sort.
-Parameters: Array A and size of the array.
+Description: Stable merge of the sorted runs A[first, middle) and
+A[middle, last) using a buffer that holds at least the shorter run. The
+shorter run is moved to the buffer and merged back from the front (left run)
+or the back (right run).
+Parameters: Array A, the start of the first run, the start of the second
+run, the end of the second run, and the buffer.
 Return: None
 */
-template <class T> void combsort(T data[], const int n) {
-  int step = n, j, k;
-  // phase 1
-  while ((step = int(step / 1.3)) > 1)
-    for (j = n - 1; j >= step; j--) {
-      k = j - step;
-      if (data[j] < data[k])
-        swap(data[j], data[k]);
-    }
-
-  // phase 2
-  bool again = true;
-  for (int i = 0; i < n - 1 && again; i++)
-    for (j = n - 1, again = false; j > i; --j)
-      if (data[j] < data[j - 1]) {
-        swap(data[j], data[j - 1]);
-        again = true;
-      }
-}
+template <class T>
+void bufferedMerge(T A[], int first, int middle, int last, T Buffer[]) {
+  int sizeL = middle - first;
+  int sizeR = last - middle;
+  if (sizeL <= sizeR) {
+    copy(A + first, A + middle, Buffer);
+    gallopMerge(Buffer, sizeL, A + middle, sizeR, A + first);
+    return;
+  }
 
-///////////////////////////////////////////////////////////
-//  Shell Sort
-///////////////////////////////////////////////////////////
+  copy(A + middle, A + last, Buffer);
+  int i = middle - 1, j = sizeR - 1, out = last - 1;
+  while (j >= 0) {
+    if (i >= first && Buffer[j] < A[i])
+      A[out--] = A[i--];
+    else
+      A[out--] = Buffer[j--];
+  }
+}
 
 /*
-Description: Sorts the array using the standard Shell sort.
-Parameters: Array A and size of the array.
+Description: Stable merge of the sorted runs A[first, middle) and
+A[middle, last) with a buffer of bufferSize entries, which may be 0. When
+the shorter run fits in the buffer the merge is bufferedMerge. Otherwise
+the longer run is cut in half, the matching cut in the other run is found
+by binary search, and rotating the two middle pieces past each other leaves
+two smaller merges, of which the smaller is recursed into and the larger is
+looped on.
+Parameters: Array A, the start of the first run, the start of the second
+run, the end of the second run, the buffer and its size.
 Return: None
+Notes: Rotation merging costs O(n log n) moves per merge at worst, but the
+pieces shrink quickly to the buffer size, so with a buffer of sqrt(n)
+entries nearly every merge ends up buffered.
 */
-template <class T> void Shellsort(T data[], int n) {
-  int i, j, hCnt, h;
-  int increments[20], k;
-  // create an appropriate number of increments h
-  for (h = 1, i = 0; h < n; i++) {
-    increments[i] = h;
-    h = 3 * h + 1;
-  }
-  // loop on the number of different increments h
-  for (i--; i >= 0; i--) {
-    h = increments[i];
-    // loop on the number of subarrays h-sorted in ith pass
-    for (hCnt = h; hCnt < 2 * h; hCnt++) {
-      // insertion sort for subarray containing every hth element of
-      for (j = hCnt; j < n;) { // array data
-        T tmp = data[j];
-        k = j;
-        while (k - h >= 0 && tmp < data[k - h]) {
-          data[k] = data[k - h];
-          k -= h;
-        }
-        data[k] = tmp;
-        j += h;
-      }
+template <class T>
+void inPlaceMerge(T A[], int first, int middle, int last, T Buffer[],
+                  int bufferSize) {
+  while (first < middle && middle < last && A[middle] < A[middle - 1]) {
+    int sizeL = middle - first;
+    int sizeR = last - middle;
+    if (min(sizeL, sizeR) <= bufferSize) {
+      bufferedMerge(A, first, middle, last, Buffer);
+      return;
+    }
+    if (sizeL + sizeR == 2) {
+      swap(A[first], A[middle]);
+      return;
+    }
+
+    int cutL, cutR;
+    if (sizeL > sizeR) {
+      cutL = first + sizeL / 2;
+      cutR = lower_bound(A + middle, A + last, A[cutL]) - A;
+    } else {
+      cutR = middle + sizeR / 2;
+      cutL = upper_bound(A + first, A + middle, A[cutR]) - A;
     }
+    rotate(A + cutL, A + middle, A + cutR);
+    int split = cutL + (cutR - middle);
+
+    if (split - first < last - split) {
+      inPlaceMerge(A, first, cutL, split, Buffer, bufferSize);
+      first = split;
+      middle = cutR;
+    } else {
+      inPlaceMerge(A, split, cutR, last, Buffer, bufferSize);
+      last = split;
+      middle = cutL;
+    }
+  }
+}
+
+/*
+Description: Stable merge sort that needs no n-entry scratch array. Runs of
+MERGE_RUN entries are sorted first, then passes of inPlaceMerge join pairs
+of runs in place, as in bottomUpMergeSort.
+Parameters: Array A, size of the array, and a caller-owned buffer and its
+size. The buffer can be any size, including nullptr and 0 for a sort with
+O(1) extra memory (plus O(log n) stack); bigger buffers make it faster.
+Return: None
+Notes: The overload without a buffer allocates one of sqrt(size) entries.
+*/
+template <class T>
+void inPlaceMergeSort(T A[], int size, T Buffer[], int bufferSize) {
+  if (size < 2)
+    return;
+
+  for (int start = 0; start < size; start += MERGE_RUN) {
+    int run = min(MERGE_RUN, size - start);
+    if (is_integral<T>::value)
+      smallSort(A + start, run);
+    else
+      insertion(A + start, run);
   }
+
+  for (int width = MERGE_RUN; width < size; width *= 2)
+    for (int lo = 0; lo + width < size; lo += 2 * width)
+      inPlaceMerge(A, lo, lo + width, min(lo + 2 * width, size), Buffer,
+                   bufferSize);
+}
+
+template <class T> void inPlaceMergeSort(T A[], int size) {
+  int bufferSize = static_cast<int>(sqrt(static_cast<double>(size)));
+  T *buffer = new T[bufferSize + 1];
+  inPlaceMergeSort(A, size, buffer, bufferSize);
+  delete[] buffer;
 }
 
 ///////////////////////////////////////////////////////////
-//  Heap Sort
+//  Tim Sort: natural merge sort with the powersort merge policy
 ///////////////////////////////////////////////////////////
 
 /*
-Description: Restores the heap property on the array segment.
-Parameters: Array A and the first and last index to restore.
+Description: Minimum run length for an array of n entries. Takes the six
+leading bits of n and adds one if any of the remaining bits are set, so
+n / minrun is a power of two or slightly less (as in TimSort).
+Parameters: Size of the array.
+Return: Minimum run length, between 32 and 64 for n of at least 64.
+*/
+inline int minRunLength(int n) {
+  int r = 0;
+  while (n >= 64) {
+    r |= n & 1;
+    n >>= 1;
+  }
+  return n + r;
+}
+
+/*
+Description: Finds the natural run starting at start. Strictly descending
+runs are reversed in place; strictness keeps the sort stable.
+Parameters: Array A, start of the run and size of the array.
+Return: Length of the run.
+*/
+template <class T> int naturalRun(T A[], int start, int size) {
+  int end = start + 1;
+  if (end == size)
+    return 1;
+
+  if (A[end] < A[start]) {
+    while (end + 1 < size && A[end + 1] < A[end])
+      end++;
+    reverse(A + start, A + end + 1);
+  } else {
+    while (end + 1 < size && !(A[end + 1] < A[end]))
+      end++;
+  }
+  return end - start + 1;
+}
+
+/*
+Description: Powersort node power of the boundary between two adjacent runs:
+the depth at which the boundary would split the array in a perfectly
+balanced merge tree, computed from the run midpoints. Merging by decreasing
+power is within a few percent of the optimal merge order.
+Parameters: Start and length of the first run, length of the second run and
+size of the array.
+Return: Node power of the boundary.
+*/
+inline int nodePower(int start1, int len1, int len2, int n) {
+  long long a = 2LL * start1 + len1; // twice the first midpoint
+  long long b = a + len1 + len2;     // twice the second midpoint
+  int power = 0;
+  while (true) {
+    power++;
+    if (a >= n) {
+      a -= n;
+      b -= n;
+    } else if (b >= n) {
+      break;
+    }
+    a <<= 1;
+    b <<= 1;
+  }
+  return power;
+}
+
+/*
+Description: Merges the adjacent sorted runs A[start, start + lenA) and
+A[start + lenA, start + lenA + lenB) in place. Entries of the first run
+that are not above the second run's first entry, and entries of the second
+run that are not below the first run's last entry, are already in place
+and are found with galloping searches, so only the overlap is merged.
+Parameters: Array A, start and length of the first run, length of the
+second run and a buffer of at least lenA entries.
 Return: None
 */
-template <class T> void moveDown(T data[], int first, int last) {
-  int largest = 2 * first + 1;
-  while (largest <= last) {
-    if (largest < last && // first has two children (at 2*first+1 and
-        data[largest] < data[largest + 1]) // 2*first+2) and the second
-      largest++;                           // is larger than the first;
+template <class T>
+void mergeAdjacentRuns(T A[], int start, int lenA, int lenB, T Buffer[]) {
+  T *B = A + start + lenA;
 
-    if (data[first] < data[largest]) {  // if necessary,
-      swap(data[first], data[largest]); // swap child and parent,
-      first = largest;                  // and move down;
-      largest = 2 * first + 1;
-    } else
-      largest = last + 1; // to exit the loop: the heap property
-  }                       // isn't violated by data[first];
+  int skip = gallopRight(B[0], A + start, lenA);
+  start += skip;
+  lenA -= skip;
+  if (lenA == 0)
+    return;
+
+  lenB = gallopLeft(A[start + lenA - 1], B, lenB);
+  if (lenB == 0)
+    return;
+
+  copy(A + start, A + start + lenA, Buffer);
+  gallopMerge(Buffer, lenA, B, lenB, A + start);
 }
 
 /*
-Description: Sorts the array using the standard heap sort.
-Parameters: Array A and size of the array.
+Description: Extends a short run to minRun entries (or the end of the array)
+and sorts it. Integer keys use the leaf sort, since their stability cannot be
+observed; other keys use insertion sort, which is linear over the part that
+is already a run.
+Parameters: Array A, start of the run, minimum run length and array size.
+Return: Length of the extended run.
+*/
+template <class T> int extendRun(T A[], int start, int minRun, int size) {
+  int length = min(minRun, size - start);
+  if (is_integral<T>::value)
+    smallSort(A + start, length);
+  else
+    insertion(A + start, length);
+  return length;
+}
+
+/*
+Description: Adaptive, stable merge sort. Natural runs are found left to
+right, and runs shorter than minRunLength are extended by extendRun.
+Each new run boundary gets its powersort node power, and runs on the stack
+whose boundary has a higher power are merged first, which keeps the merge
+tree balanced with respect to the run lengths. Already sorted and reversed
+input take linear time, and a few runs take O(n log r) for r runs.
+Parameters: Array A, size of the array, and an optional scratch buffer of
+at least size entries that can be reused across calls.
 Return: None
+Notes: Without a scratch buffer one is allocated for the call.
 */
-template <class T> void heapsort(T data[], const int n) {
-  int i;
-  for (i = n / 2 - 1; i >= 0; --i) // create the heap;
-    moveDown(data, i, n - 1);
-  for (i = n - 1; i >= 1; --i) {
-    swap(data[0], data[i]);   // move the largest item to data[i];
-    moveDown(data, 0, i - 1); // restore the heap property;
+template <class T> void timSort(T A[], int size, T Scratch[]) {
+  if (size < 2)
+    return;
+
+  int minRun = minRunLength(size);
+  T *buffer = Scratch != nullptr ? Scratch : new T[size];
+
+  // runs waiting to be merged, with the power of the boundary to their right
+  vector<int> runStart;
+  vector<int> runPower;
+
+  int start = 0;
+  int length = naturalRun(A, 0, size);
+  if (length < minRun)
+    length = extendRun(A, 0, minRun, size);
+
+  while (start + length < size) {
+    int nextStart = start + length;
+    int nextLength = naturalRun(A, nextStart, size);
+    if (nextLength < minRun)
+      nextLength = extendRun(A, nextStart, minRun, size);
+
+    int power = nodePower(start, length, nextLength, size);
+    while (!runPower.empty() && runPower.back() > power) {
+      int leftStart = runStart.back();
+      mergeAdjacentRuns(A, leftStart, start - leftStart, length, buffer);
+      length += start - leftStart;
+      start = leftStart;
+      runStart.pop_back();
+      runPower.pop_back();
+    }
+
+    runStart.push_back(start);
+    runPower.push_back(power);
+    start = nextStart;
+    length = nextLength;
+  }
+
+  while (!runStart.empty()) {
+    int leftStart = runStart.back();
+    mergeAdjacentRuns(A, leftStart, start - leftStart, length, buffer);
+    length += start - leftStart;
+    start = leftStart;
+    runStart.pop_back();
+    runPower.pop_back();
   }
+
+  if (Scratch == nullptr)
+    delete[] buffer;
 }
 
 ///////////////////////////////////////////////////////////
-//  Radix Sort: implementation for integer data.
+//  Loser Tree: k-way merge selection
 ///////////////////////////////////////////////////////////
 
 /*
-Description: Sorts the array using the standard radix sort.
-Parameters: Array A, size of the array, and radix to use.
+Description: Tournament tree of losers for merging k sorted sources. Every
+internal node keeps the loser of the match played there and tree[0] keeps
+the overall winner, so when the winner's source moves on only the log k
+matches on the path from its leaf to the root are replayed, each against a
+single stored loser. Ties go to the lower source, which keeps k-way merges
+stable, and sources that have run out lose every match.
+Notes: Call set() for every source that has a first key, then build().
+*/
+template <class T> class LoserTree {
+public:
+  explicit LoserTree(int sources)
+      : k(sources), keys(sources), live(sources, false),
+        tree(max(sources, 1), 0) {}
+
+  void set(int source, const T &key) {
+    keys[source] = key;
+    live[source] = true;
+  }
+
+  void build();
+  bool empty() const { return k == 0 || !live[tree[0]]; }
+  int winner() const { return tree[0]; }
+  const T &winnerKey() const { return keys[tree[0]]; }
+
+  void replaceWinner(const T &key) {
+    keys[tree[0]] = key;
+    replay(tree[0]);
+  }
+
+  void closeWinner() {
+    live[tree[0]] = false;
+    replay(tree[0]);
+  }
+
+private:
+  int k;
+  vector<T> keys;
+  vector<unsigned char> live; // bytes, so the replay loop avoids bit masking
+  vector<int> tree; // leaves are the implicit nodes k .. 2k - 1
+
+  bool beats(int a, int b) const {
+    if (live[a] & live[b]) {
+      if (keys[a] < keys[b])
+        return true;
+      if (keys[b] < keys[a])
+        return false;
+      return a < b;
+    }
+    return live[a];
+  }
+
+  void replay(int source);
+};
+
+/*
+Description: Plays the initial tournament bottom-up.
+Parameters: None
 Return: None
-Notes: This is for integer data only.
 */
-template <class T> void radixsort(T data[], const int n, const int radix) {
-  T d, j, k, factor;
-  T max = data[0];
-  for (int i = 0; i < n; i++)
-    if (max < data[i])
-      max = data[i];
-
-  deque<T> queues[radix];
-  for (d = 0, factor = 1; max / factor > 0; factor *= radix, d++) {
-    for (j = 0; j < n; j++)
-      queues[(data[j] / factor) % radix].push_back(data[j]);
-    for (j = k = 0; j < radix; j++)
-      while (!queues[j].empty()) {
-        data[k++] = queues[j].front();
-        queues[j].pop_front();
-      }
+template <class T> void LoserTree<T>::build() {
+  if (k <= 1)
+    return;
+
+  vector<int> winners(2 * k);
+  for (int i = 0; i < k; i++)
+    winners[k + i] = i;
+
+  for (int node = k - 1; node >= 1; node--) {
+    int a = winners[2 * node];
+    int b = winners[2 * node + 1];
+    winners[node] = beats(a, b) ? a : b;
+    tree[node] = beats(a, b) ? b : a;
   }
+  tree[0] = winners[1];
+}
+
+/*
+Description: Replays the matches from a source's leaf to the root after its
+key changed.
+Parameters: Source whose key changed.
+Return: None
+*/
+template <class T> void LoserTree<T>::replay(int source) {
+  for (int node = (source + k) / 2; node >= 1; node /= 2)
+    if (beats(tree[node], source))
+      swap(tree[node], source);
+  tree[0] = source;
 }
 
 ///////////////////////////////////////////////////////////
-//  Count Sort: implementation for positive integer data.
+//  Multiway Merge: k sorted runs in one pass
 ///////////////////////////////////////////////////////////
 
+// Merges of at most this many entries run on a single thread.
+const int MULTIWAY_PARALLEL_CUTOFF = 1 << 15;
+
+/*
+Description: A sorted run that is read but not owned by the merge.
+*/
+template <class T> struct SortedRun {
+  const T *data;
+  int length;
+};
+
+/*
+Description: Merges the slice [first[r], last[r]) of every run into Out.
+One run is copied, two runs go through gallopMerge, and more runs are
+merged by a LoserTree, which costs log k comparisons per entry.
+Parameters: Runs, starting and ending positions within each run, and the
+output array.
+Return: None
+Notes: Equal entries come out in run order, so the merge is stable.
+*/
+template <class T>
+void multiwayMergeSlice(const vector<SortedRun<T>> &runs,
+                        const vector<int> &first, const vector<int> &last,
+                        T Out[]) {
+  vector<int> live;
+  for (int r = 0; r < static_cast<int>(runs.size()); r++)
+    if (first[r] < last[r])
+      live.push_back(r);
+
+  if (live.empty())
+    return;
+  if (live.size() == 1) {
+    const T *run = runs[live[0]].data;
+    copy(run + first[live[0]], run + last[live[0]], Out);
+    return;
+  }
+  if (live.size() == 2) {
+    int a = live[0], b = live[1];
+    gallopMerge(runs[a].data + first[a], last[a] - first[a],
+                runs[b].data + first[b], last[b] - first[b], Out);
+    return;
+  }
+
+  int k = live.size();
+  vector<int> pos(k);
+  LoserTree<T> tree(k);
+  for (int s = 0; s < k; s++) {
+    pos[s] = first[live[s]];
+    tree.set(s, runs[live[s]].data[pos[s]]);
+  }
+  tree.build();
+
+  while (!tree.empty()) {
+    int s = tree.winner();
+    *Out++ = tree.winnerKey();
+    if (++pos[s] < last[live[s]])
+      tree.replaceWinner(runs[live[s]].data[pos[s]]);
+    else
+      tree.closeWinner();
+  }
+}
+
+/*
+Description: Co-ranking of k sorted runs. Entries are ordered by value, then
+by run, then by position, which is the order the stable merge writes them
+in. Every run keeps a window [low, high) known to contain its split. Each
+round takes the weighted median of the window middles as a pivot value and
+finds, with lower_bound and upper_bound in every window, how many entries
+are below and not above it. Either the rank falls among the entries equal to
+the pivot, which are then shared out in run order, or every window is cut at
+the pivot.
+Parameters: Runs, output rank, and the positions to fill in, one per run.
+Return: None
+Notes: The positions always add up to rank, so slices cut at consecutive
+ranks can be merged independently. A round costs O(k log n), and the median
+pivot removes at least a quarter of the window entries, so there are
+O(log total) rounds.
+*/
+template <class T>
+void coRankRuns(const vector<SortedRun<T>> &runs, long long rank,
+                vector<int> &split) {
+  int k = runs.size();
+  vector<int> low(k, 0), high(k), below(k), notAbove(k), open;
+  for (int r = 0; r < k; r++)
+    high[r] = runs[r].length;
+  auto middle = [&](int r) -> const T & {
+    return runs[r].data[low[r] + (high[r] - low[r]) / 2];
+  };
+
+  while (true) {
+    open.clear();
+    long long window = 0;
+    for (int r = 0; r < k; r++)
+      if (low[r] < high[r]) {
+        open.push_back(r);
+        window += high[r] - low[r];
+      }
+    if (open.empty())
+      break;
+
+    sort(open.begin(), open.end(),
+         [&](int a, int b) { return middle(a) < middle(b); });
+    int median = open.back();
+    long long weight = 0;
+    for (int r : open) {
+      weight += high[r] - low[r];
+      if (2 * weight >= window) {
+        median = r;
+        break;
+      }
+    }
+
+    const T &pivot = middle(median);
+    long long less = 0, notGreater = 0;
+    for (int r = 0; r < k; r++) {
+      const T *run = runs[r].data;
+      below[r] = lower_bound(run + low[r], run + high[r], pivot) - run;
+      notAbove[r] = upper_bound(run + below[r], run + high[r], pivot) - run;
+      less += below[r];
+      notGreater += notAbove[r];
+    }
+
+    if (rank <= less)
+      high = below;
+    else if (rank >= notGreater)
+      low = notAbove;
+    else {
+      // the rank falls among the entries equal to pivot
+      long long remaining = rank - less;
+      for (int r = 0; r < k; r++) {
+        long long take = min<long long>(notAbove[r] - below[r], remaining);
+        split[r] = below[r] + static_cast<int>(take);
+        remaining -= take;
+      }
+      return;
+    }
+  }
+  split = low;
+}
+
 /*
-Description: Sorts the array using the standard count sort.
-Parameters: Array A and the size of the array.
+Description: Merges k sorted runs into Out in a single pass. With threads,
+the output is cut into one slice per thread, the slice boundaries are
+co-ranked into every run as tasks on the pool, and each thread merges its
+slice independently.
+Parameters: Runs, output array with room for every entry, and the number of
+threads to use.
 Return: None
-Notes: This is for positive integer data only.
+Notes: The runs must not overlap Out. The merge is stable: equal entries
+keep their run order.
 */
-template <class T> void countsort(T *A, long sz) {
-  T maxval = A[0];
-  for (int i = 0; i < sz; i++)
-    maxval = max(maxval, A[i]);
+template <class T>
+void multiwayMerge(const vector<SortedRun<T>> &runs, T Out[], int threads) {
+  int k = runs.size();
+  long long total = 0;
+  for (int r = 0; r < k; r++)
+    total += runs[r].length;
 
-  int *counts = new int[maxval + 1]();
-  int *temp = new int[sz];
+  vector<int> first(k, 0), last(k);
+  for (int r = 0; r < k; r++)
+    last[r] = runs[r].length;
 
-  for (int i = 0; i < sz; i++)
-    counts[A[i]]++;
+  if (threads <= 1 || total <= MULTIWAY_PARALLEL_CUTOFF) {
+    multiwayMergeSlice(runs, first, last, Out);
+    return;
+  }
 
-  for (int i = 1; i < maxval + 1; i++)
-    counts[i] += counts[i - 1];
+  vector<vector<int>> splits(threads + 1, vector<int>(k));
+  splits[0] = first;
+  splits[threads] = last;
 
-  for (int i = 0; i < sz; i++)
-    temp[--counts[A[i]]] = A[i];
+  WorkStealingPool pool(threads);
+  TaskGroup group(pool);
+  for (int t = 1; t < threads; t++)
+    group.run([&, t]() { coRankRuns(runs, total * t / threads, splits[t]); });
+  group.wait();
 
-  copy(temp, temp + sz, A);
-  delete[] temp;
-  delete[] counts;
+  for (int t = 0; t < threads; t++)
+    group.run([&, t]() {
+      multiwayMergeSlice(runs, splits[t], splits[t + 1],
+                         Out + total * t / threads);
+    });
+  group.wait();
 }
 
 ///////////////////////////////////////////////////////////
-//  Bucket Sort: implementation for floating point data in [0, 1).
+//  Parallel Merge Sort
 ///////////////////////////////////////////////////////////
 
+// Ranges at or below these sizes are sorted or merged on a single thread.
+const int PARALLEL_SORT_CUTOFF = 1 << 15;
+const int PARALLEL_MERGE_CUTOFF = 1 << 15;
+
 /*
-Description: Sorts the array using the standard bucket sort.
-Parameters: Array A and the size of the array.
-Return: Type T sorted array
-Notes: This is for floating point data only in the range [0, 1). */
-template <class T> void BucketSort(T *A, long sz) {
-  //	deque<T> *Buckets = new deque<T> [sz];
-  vector<T> *Buckets = new vector<T>[sz];
-  for (long i = 0; i < sz; i++)
-    Buckets[static_cast<long>(sz * A[i])].push_back(A[i]);
+Description: Parallel merge of two sorted runs. The larger run is split at
+its middle element, the matching split point in the other run is found by
+binary search, and the two independent halves are merged concurrently.
+Parameters: First run and its length, second run and its length, output
+array, and the pool that runs the forked halves.
+Return: None
+*/
+template <class T>
+void parallelMerge(const T A[], int sizeA, const T B[], int sizeB, T Out[],
+                   WorkStealingPool &pool) {
+  if (sizeA + sizeB <= PARALLEL_MERGE_CUTOFF) {
+    gallopMerge(A, sizeA, B, sizeB, Out);
+    return;
+  }
 
-  //	for (long i = 0; i < sz; i++)
-  //		sort(Buckets[i].begin(), Buckets[i].end());
+  int splitA, splitB;
+  if (sizeA >= sizeB) {
+    splitA = sizeA / 2;
+    splitB = lower_bound(B, B + sizeB, A[splitA]) - B;
+  } else {
+    splitB = sizeB / 2;
+    splitA = upper_bound(A, A + sizeA, B[splitB]) - A;
+  }
 
-  for (long i = 0; i < sz; i++)
-    insertion(Buckets[i].data(), Buckets[i].size());
+  TaskGroup halves(pool);
+  halves.run([=, &pool]() { parallelMerge(A, splitA, B, splitB, Out, pool); });
+  parallelMerge(A + splitA, sizeA - splitA, B + splitB, sizeB - splitB,
+                Out + splitA + splitB, pool);
+  halves.wait();
+}
 
-  int pos = 0;
-  for (long i = 0; i < sz; i++)
-    for (unsigned long j = 0; j < Buckets[i].size(); j++)
-      A[pos++] = Buckets[i][j];
+/*
+Description: Recursive subdividing portion of the parallel merge sort. The two
+halves are forked onto the pool, merged in parallel into the temp array, and
+copied back in parallel blocks.
+Parameters: Array A, temp array, starting and ending positions of the
+portion being subdivided, and the pool to run on.
+Return: None
+*/
+template <class T>
+void parallelMergeSort(T A[], T Temp[], int start, int end,
+                       WorkStealingPool &pool) {
+  if (end - start + 1 <= PARALLEL_SORT_CUTOFF) {
+    bottomUpMergeSort(A + start, end - start + 1, Temp + start);
+    return;
+  }
+
+  int mid = (start + end) / 2;
+  TaskGroup halves(pool);
+  halves.run([=, &pool]() { parallelMergeSort(A, Temp, start, mid, pool); });
+  parallelMergeSort(A, Temp, mid + 1, end, pool);
+  halves.wait();
+
+  parallelMerge(A + start, mid - start + 1, A + mid + 1, end - mid,
+                Temp + start, pool);
+
+  for (int block = start; block <= end; block += PARALLEL_MERGE_CUTOFF) {
+    int blockEnd = min(end + 1, block + PARALLEL_MERGE_CUTOFF);
+    halves.run([=]() { copy(Temp + block, Temp + blockEnd, A + block); });
+  }
+  halves.wait();
+}
+
+/*
+Description: Non-recursive starting function for the parallel merge sort.
+Parameters: Array A, size of the array and the number of threads to use.
+Return: None
+Notes: One thread (or a small array) runs the serial merge sort.
+*/
+template <class T> void mergeSort(T A[], int size, int threads) {
+  if (threads <= 1 || size <= PARALLEL_SORT_CUTOFF) {
+    mergeSort(A, size);
+    return;
+  }
+
+  WorkStealingPool pool(threads);
+  T *Temp = new T[size];
+  parallelMergeSort(A, Temp, 0, size - 1, pool);
+  delete[] Temp;
+}
+
+///////////////////////////////////////////////////////////
+//  Quick Sort
+///////////////////////////////////////////////////////////
 
-  delete[] Buckets;
+/*
+Description: Hoare partition used by the quick sorts. Elements less than the
+pivot end up before i and elements greater than the pivot end up after j.
+Parameters: Array A, starting and ending positions of the portion being
+partitioned, pivot value, and the i and j positions, which are set to the
+start of the right part and the end of the left part respectively.
+Return: None
+*/
+template <class T>
+void quickPartition(T A[], int left, int right, T pivot, int &i, int &j) {
+  i = left;
+  j = right;
+
+  while (i <= j) {
+    while (A[i] < pivot)
+      i++;
+
+    while (A[j] > pivot)
+      j--;
+
+    if (i <= j) {
+      T tmp = A[i];
+      A[i] = A[j];
+      A[j] = tmp;
+      i++;
+      j--;
+    }
+  }
+}
+
+/*
+Description: Recursive subdividing portion of the quick sort algorithm.
+Parameters: Array A, starting and ending positions of the portion being
+subdivided.
+Return: None
+Notes: Small int, float and double portions are sorted by a SIMD network.
+*/
+template <class T> void quickSort(T A[], int left, int right) {
+  if (right - left < NETWORK_MAX_BLOCK &&
+      networkSort(A + left, right - left + 1))
+    return;
+
+  int i, j;
+  int mid = (left + right) / 2;
+
+  quickPartition(A, left, right, A[mid], i, j);
+
+  if (left < j)
+    quickSort(A, left, j);
+
+  if (i < right)
+    quickSort(A, i, right);
+}
+
+/*
+Description: Non-recursive starting function for the quick sort.
+Parameters: Array A and size of the array.
+Return: None
+Notes: Arithmetic types are sorted by blockQuickSort, whose partition has no
+data-dependent branches (and uses AVX2 for int and float keys when the CPU
+has it). Other types use introSort, whose depth limit keeps inputs such as
+organ-pipe strings from going quadratic or overflowing the stack in the
+unbounded recursive quickSort above.
+*/
+template <class T> void quickSort(T A[], int size) {
+  if (is_arithmetic<T>::value)
+    blockQuickSort(A, size);
+  else
+    introSort(A, size);
+}
+
+///////////////////////////////////////////////////////////
+//  Intro Sort
+///////////////////////////////////////////////////////////
+
+// Ranges at or below this size are finished with insertion sort.
+const int INTROSORT_THRESHOLD = 16;
+// Ranges above this size take the ninther instead of the median of three.
+const int NINTHER_THRESHOLD = 128;
+
+/*
+Description: Finds the median of three array entries.
+Parameters: Array A and the three positions to compare.
+Return: Position of the median entry.
+*/
+template <class T> int medianOfThree(T A[], int a, int b, int c) {
+  if (A[a] < A[b]) {
+    if (A[b] < A[c])
+      return b;
+    return A[a] < A[c] ? c : a;
+  }
+  if (A[a] < A[c])
+    return a;
+  return A[b] < A[c] ? c : b;
+}
+
+/*
+Description: Chooses a pivot position, using the median of the first, middle
+and last entries for small ranges and Tukey's ninther (median of three
+medians of three) for large ones.
+Parameters: Array A, starting and ending positions of the range.
+Return: Position of the pivot entry.
+*/
+template <class T> int choosePivot(T A[], int left, int right) {
+  int mid = left + (right - left) / 2;
+  if (right - left + 1 <= NINTHER_THRESHOLD)
+    return medianOfThree(A, left, mid, right);
+
+  int eighth = (right - left + 1) / 8;
+  int a = medianOfThree(A, left, left + eighth, left + 2 * eighth);
+  int b = medianOfThree(A, mid - eighth, mid, mid + eighth);
+  int c = medianOfThree(A, right - 2 * eighth, right - eighth, right);
+  return medianOfThree(A, a, b, c);
+}
+
+/*
+Description: Recursive portion of the intro sort. Partitions like quickSort
+around a ninther pivot, recurses into the smaller side and loops on the
+larger one, switches to heapsort once the depth limit is used up, and leaves
+small ranges to insertion sort.
+Parameters: Array A, starting and ending positions of the portion being
+sorted, and the number of partitioning levels left before heapsort.
+Return: None
+*/
+template <class T> void introSort(T A[], int left, int right, int depthLimit) {
+  while (right - left + 1 > INTROSORT_THRESHOLD) {
+    if (depthLimit == 0) {
+      heapsort(A + left, right - left + 1);
+      return;
+    }
+    depthLimit--;
+
+    int i, j;
+    quickPartition(A, left, right, A[choosePivot(A, left, right)], i, j);
+
+    if (j - left < right - i) {
+      introSort(A, left, j, depthLimit);
+      left = i;
+    } else {
+      introSort(A, i, right, depthLimit);
+      right = j;
+    }
+  }
+  smallSort(A + left, right - left + 1);
+}
+
+/*
+Description: Non-recursive starting function for the intro sort.
+Parameters: Array A and size of the array.
+Return: None
+Notes: The depth limit is 2*log2(size).
+*/
+template <class T> void introSort(T A[], int size) {
+  int depthLimit = 0;
+  for (int n = size; n > 1; n /= 2)
+    depthLimit += 2;
+
+  introSort(A, 0, size - 1, depthLimit);
+}
+
+///////////////////////////////////////////////////////////
+//  Three-Way and Dual-Pivot Quick Sort
+///////////////////////////////////////////////////////////
+
+/*
+Description: Three-way (Dutch national flag) partition. One scan sorts the
+portion into keys less than, equal to and greater than the pivot, so keys
+equal to the pivot end up together in the middle, in their final place.
+Parameters: Array A, starting and ending positions of the portion being
+partitioned, pivot value, and the lt and gt positions, which are set to the
+first and last entries equal to the pivot.
+Return: None
+Notes: The pivot must be one of the keys in the portion.
+*/
+template <class T>
+void threeWayPartition(T A[], int left, int right, T pivot, int &lt,
+                       int &gt) {
+  lt = left;
+  gt = right;
+  int k = left;
+  while (k <= gt) {
+    if (A[k] < pivot)
+      swap(A[lt++], A[k++]);
+    else if (pivot < A[k])
+      swap(A[k], A[gt--]);
+    else
+      k++;
+  }
+}
+
+/*
+Description: Recursive portion of the three-way quick sort. Works like
+introSort, but the keys equal to the pivot are never looked at again, so an
+array with d distinct keys takes at most d levels of partitioning.
+Parameters: Array A, starting and ending positions of the portion being
+sorted, and the number of partitioning levels left before heapsort.
+Return: None
+*/
+template <class T>
+void threeWayQuickSort(T A[], int left, int right, int depthLimit) {
+  while (right - left + 1 > INTROSORT_THRESHOLD) {
+    if (depthLimit == 0) {
+      heapsort(A + left, right - left + 1);
+      return;
+    }
+    depthLimit--;
+
+    int lt, gt;
+    threeWayPartition(A, left, right, A[choosePivot(A, left, right)], lt, gt);
+
+    if (lt - left < right - gt) {
+      threeWayQuickSort(A, left, lt - 1, depthLimit);
+      left = gt + 1;
+    } else {
+      threeWayQuickSort(A, gt + 1, right, depthLimit);
+      right = lt - 1;
+    }
+  }
+  smallSort(A + left, right - left + 1);
+}
+
+/*
+Description: Non-recursive starting function for the three-way quick sort.
+Parameters: Array A and size of the array.
+Return: None
+Notes: The depth limit is 2*log2(size), as in introSort.
+*/
+template <class T> void threeWayQuickSort(T A[], int size) {
+  int depthLimit = 0;
+  for (int n = size; n > 1; n /= 2)
+    depthLimit += 2;
+
+  threeWayQuickSort(A, 0, size - 1, depthLimit);
+}
+
+/*
+Description: Dual-pivot partition (Yaroslavskiy). With pivots p = A[left]
+and q = A[right], p <= q, one scan splits the portion into keys less than
+p, keys from p up to but not including q, and keys not less than q, and
+then puts the pivots between the parts.
+Parameters: Array A, starting and ending positions of the portion being
+partitioned, and the lt and gt positions, which are set to the final
+positions of p and q.
+Return: None
+*/
+template <class T>
+void dualPivotPartition(T A[], int left, int right, int &lt, int &gt) {
+  T p = A[left], q = A[right];
+  int l = left + 1, g = right - 1;
+  for (int k = l; k <= g; k++) {
+    if (A[k] < p) {
+      swap(A[k], A[l++]);
+    } else if (!(A[k] < q)) {
+      while (q < A[g] && k < g)
+        g--;
+      swap(A[k], A[g--]);
+      if (A[k] < p)
+        swap(A[k], A[l++]);
+    }
+  }
+  lt = l - 1;
+  gt = g + 1;
+  swap(A[left], A[lt]);
+  swap(A[right], A[gt]);
+}
+
+/*
+Description: Recursive portion of the dual-pivot quick sort. The pivots are
+the second and fourth of five keys spread over the portion. When they are
+equal the portion is split with threeWayPartition instead, since every key
+equal to them would otherwise go right and be partitioned again. When the
+middle part holds most of the portion, the keys in it equal to p are
+gathered at its front first and left out of the recursion.
+Parameters: Array A, starting and ending positions of the portion being
+sorted, and the number of partitioning levels left before heapsort.
+Return: None
+*/
+template <class T>
+void dualPivotQuickSort(T A[], int left, int right, int depthLimit) {
+  while (right - left + 1 > INTROSORT_THRESHOLD) {
+    if (depthLimit == 0) {
+      heapsort(A + left, right - left + 1);
+      return;
+    }
+    depthLimit--;
+
+    int n = right - left + 1;
+    int seventh = n / 7;
+    int e3 = left + n / 2;
+    int sample[5] = {e3 - 2 * seventh, e3 - seventh, e3, e3 + seventh,
+                     e3 + 2 * seventh};
+    for (int a = 1; a < 5; a++)
+      for (int b = a; b > 0 && A[sample[b]] < A[sample[b - 1]]; b--)
+        swap(A[sample[b]], A[sample[b - 1]]);
+
+    if (!(A[sample[1]] < A[sample[3]])) {
+      int lt, gt;
+      threeWayPartition(A, left, right, A[sample[1]], lt, gt);
+      dualPivotQuickSort(A, left, lt - 1, depthLimit);
+      left = gt + 1;
+      continue;
+    }
+
+    swap(A[left], A[sample[1]]);
+    swap(A[right], A[sample[3]]);
+    int lt, gt;
+    dualPivotPartition(A, left, right, lt, gt);
+
+    int low = lt + 1;
+    if (gt - low > n * 4 / 7) {
+      for (int k = low; k < gt; k++)
+        if (!(A[lt] < A[k]))
+          swap(A[k], A[low++]);
+    }
+
+    dualPivotQuickSort(A, left, lt - 1, depthLimit);
+    dualPivotQuickSort(A, low, gt - 1, depthLimit);
+    left = gt + 1;
+  }
+  smallSort(A + left, right - left + 1);
+}
+
+/*
+Description: Non-recursive starting function for the dual-pivot quick sort.
+Parameters: Array A and size of the array.
+Return: None
+Notes: The depth limit is 2*log2(size), as in introSort.
+*/
+template <class T> void dualPivotQuickSort(T A[], int size) {
+  int depthLimit = 0;
+  for (int n = size; n > 1; n /= 2)
+    depthLimit += 2;
+
+  dualPivotQuickSort(A, 0, size - 1, depthLimit);
+}
+
+///////////////////////////////////////////////////////////
+//  Block Quick Sort: branchless partitioning
+///////////////////////////////////////////////////////////
+
+// Number of elements classified at a time by the block partition.
+const int PARTITION_BLOCK = 128;
+
+/*
+Description: Branchless block partition (Edelkamp and Weiss, BlockQuicksort).
+A block of elements at each end is classified against the pivot, storing the
+offsets of misplaced elements into a buffer with an unconditional write and a
+conditional increment instead of a branch. Pairs of misplaced elements are
+then swapped, and an end moves on once its block has been used up. The few
+elements left at the end are finished with a plain partition.
+Parameters: Array A, size of the array and pivot value. With EqualRight
+elements equal to the pivot go right, otherwise they go left.
+Return: Number of elements that went left.
+*/
+template <bool EqualRight, class T>
+int blockPartition(T A[], int n, const T &pivot) {
+  auto goesRight = [&pivot](const T &x) {
+    return EqualRight ? !(x < pivot) : pivot < x;
+  };
+
+  unsigned char offsetsL[PARTITION_BLOCK], offsetsR[PARTITION_BLOCK];
+  int numL = 0, numR = 0, startL = 0, startR = 0;
+  int l = 0;
+  int r = n;
+
+  while (r - l >= 2 * PARTITION_BLOCK) {
+    if (numL == 0) {
+      startL = 0;
+      for (int i = 0; i < PARTITION_BLOCK; i++) {
+        offsetsL[numL] = i;
+        numL += goesRight(A[l + i]);
+      }
+    }
+    if (numR == 0) {
+      startR = 0;
+      for (int i = 0; i < PARTITION_BLOCK; i++) {
+        offsetsR[numR] = i;
+        numR += !goesRight(A[r - 1 - i]);
+      }
+    }
+
+    int num = min(numL, numR);
+    for (int k = 0; k < num; k++)
+      swap(A[l + offsetsL[startL + k]], A[r - 1 - offsetsR[startR + k]]);
+
+    numL -= num;
+    numR -= num;
+    startL += num;
+    startR += num;
+    if (numL == 0)
+      l += PARTITION_BLOCK;
+    if (numR == 0)
+      r -= PARTITION_BLOCK;
+  }
+
+  int i = l;
+  int j = r - 1;
+  while (true) {
+    while (i <= j && !goesRight(A[i]))
+      i++;
+    while (i <= j && goesRight(A[j]))
+      j--;
+    if (i >= j)
+      break;
+    swap(A[i], A[j]);
+    i++;
+    j--;
+  }
+  return i;
+}
+
+/*
+Description: Partition step of blockQuickSort, using the AVX2 partition when
+there is one for T and the block partition otherwise.
+Parameters: Array A, size of the array and pivot value. With EqualRight
+elements equal to the pivot go right, otherwise they go left.
+Return: Number of elements that went left.
+*/
+template <bool EqualRight, class T>
+int branchlessPartition(T A[], int n, const T &pivot) {
+  int left = simdPartition<EqualRight>(A, n, pivot);
+  if (left >= 0)
+    return left;
+  return blockPartition<EqualRight>(A, n, pivot);
+}
+
+/*
+Description: Recursive portion of the block quick sort. Works like introSort
+but splits each range into keys less than the pivot and keys greater than or
+equal to it. When nothing is less than the pivot, the keys equal to it are
+split off instead and are already in place.
+Parameters: Array A, starting and ending positions of the portion being
+sorted, and the number of partitioning levels left before heapsort.
+Return: None
+*/
+template <class T>
+void blockQuickSort(T A[], int left, int right, int depthLimit) {
+  while (right - left + 1 > INTROSORT_THRESHOLD) {
+    if (depthLimit == 0) {
+      heapsort(A + left, right - left + 1);
+      return;
+    }
+    depthLimit--;
+
+    T pivot = A[choosePivot(A, left, right)];
+    int n = right - left + 1;
+    int mid = left + branchlessPartition<true>(A + left, n, pivot);
+    if (mid == left) {
+      left += branchlessPartition<false>(A + left, n, pivot);
+      continue;
+    }
+
+    if (mid - left < right - mid + 1) {
+      blockQuickSort(A, left, mid - 1, depthLimit);
+      left = mid;
+    } else {
+      blockQuickSort(A, mid, right, depthLimit);
+      right = mid - 1;
+    }
+  }
+  smallSort(A + left, right - left + 1);
+}
+
+/*
+Description: Non-recursive starting function for the block quick sort.
+Parameters: Array A and size of the array.
+Return: None
+Notes: The depth limit is 2*log2(size), as in introSort.
+*/
+template <class T> void blockQuickSort(T A[], int size) {
+  int depthLimit = 0;
+  for (int n = size; n > 1; n /= 2)
+    depthLimit += 2;
+
+  blockQuickSort(A, 0, size - 1, depthLimit);
+}
+
+///////////////////////////////////////////////////////////
+//  Pattern-Defeating Quick Sort
+///////////////////////////////////////////////////////////
+
+// Ranges below this size are finished with insertion sort.
+const int PDQ_INSERTION_THRESHOLD = 24;
+// Moves the partial insertion sort may make before it gives up.
+const int PDQ_PARTIAL_INSERTION_LIMIT = 8;
+// Number of elements classified at a time by the branchless partition.
+const int PDQ_BLOCK = 64;
+// Sides above this size are handed to the pool by the parallel sort.
+const size_t PDQ_PARALLEL_CUTOFF = 1 << 14;
+
+/*
+Description: Whether the less-than is cheap and free of side effects, so
+the branchless partition can evaluate it for every element without paying
+for the mispredictions of the branching one: the standard orderings on
+arithmetic types.
+*/
+template <class Less, class T>
+struct pdqBranchless
+    : integral_constant<bool, is_arithmetic<T>::value &&
+                                  (is_same<Less, less<>>::value ||
+                                   is_same<Less, less<T>>::value ||
+                                   is_same<Less, greater<>>::value ||
+                                   is_same<Less, greater<T>>::value)> {};
+
+/*
+Description: Insertion sort over iterators with a less-than callable. The
+unguarded version leaves out the check for the front of the range, which is
+safe when the entry just before first is not greater than any entry in the
+range, as it is for every range but the leftmost one in pdqSort.
+Parameters: Range [first, last) and the less-than.
+Return: None
+*/
+template <class It, class Less>
+void pdqInsertion(It first, It last, const Less &less) {
+  if (first == last)
+    return;
+  for (It i = first + 1; i != last; ++i) {
+    if (!less(*i, *(i - 1)))
+      continue;
+    auto val = std::move(*i);
+    It j = i;
+    do {
+      *j = std::move(*(j - 1));
+      --j;
+    } while (j != first && less(val, *(j - 1)));
+    *j = std::move(val);
+  }
+}
+
+template <class It, class Less>
+void pdqUnguardedInsertion(It first, It last, const Less &less) {
+  if (first == last)
+    return;
+  for (It i = first + 1; i != last; ++i) {
+    if (!less(*i, *(i - 1)))
+      continue;
+    auto val = std::move(*i);
+    It j = i;
+    do {
+      *j = std::move(*(j - 1));
+      --j;
+    } while (less(val, *(j - 1)));
+    *j = std::move(val);
+  }
+}
+
+/*
+Description: Insertion sort that gives up once it has moved more than
+PDQ_PARTIAL_INSERTION_LIMIT entries, used to finish ranges that a partition
+found already in order.
+Parameters: Range [first, last) and the less-than.
+Return: True if the range is now sorted, false if it gave up.
+*/
+template <class It, class Less>
+bool pdqPartialInsertion(It first, It last, const Less &less) {
+  if (first == last)
+    return true;
+  size_t moved = 0;
+  for (It i = first + 1; i != last; ++i) {
+    if (less(*i, *(i - 1))) {
+      auto val = std::move(*i);
+      It j = i;
+      do {
+        *j = std::move(*(j - 1));
+        --j;
+      } while (j != first && less(val, *(j - 1)));
+      *j = std::move(val);
+      moved += i - j;
+    }
+    if (moved > static_cast<size_t>(PDQ_PARTIAL_INSERTION_LIMIT))
+      return false;
+  }
+  return true;
+}
+
+/*
+Description: Sorts three entries in place.
+Parameters: The three iterators and the less-than.
+Return: None
+*/
+template <class It, class Less> void pdqSort3(It a, It b, It c, const Less &less) {
+  if (less(*b, *a))
+    iter_swap(a, b);
+  if (less(*c, *b))
+    iter_swap(b, c);
+  if (less(*b, *a))
+    iter_swap(a, b);
+}
+
+/*
+Description: Heapsort over iterators with a less-than callable, used when
+pdqSort has seen too many unbalanced partitions.
+Parameters: Range [first, last) and the less-than.
+Return: None
+*/
+template <class It, class Less>
+void pdqHeapsort(It first, It last, const Less &less) {
+  typedef typename iterator_traits<It>::difference_type Diff;
+  Diff n = last - first;
+  auto siftDown = [&](Diff root, Diff end) {
+    auto val = std::move(first[root]);
+    Diff child;
+    while ((child = 2 * root + 1) < end) {
+      if (child + 1 < end && less(first[child], first[child + 1]))
+        child++;
+      if (!less(val, first[child]))
+        break;
+      first[root] = std::move(first[child]);
+      root = child;
+    }
+    first[root] = std::move(val);
+  };
+
+  for (Diff i = n / 2 - 1; i >= 0; i--)
+    siftDown(i, n);
+  for (Diff end = n - 1; end > 0; end--) {
+    iter_swap(first, first + end);
+    siftDown(0, end);
+  }
+}
+
+/*
+Description: Partitions around the pivot at *first, sending entries equal
+to it right. Both scans are bounded by the median selection, which leaves
+an entry not less than the pivot at the back and one not greater at the
+front. If the first pair of scans meet without a swap the range was already
+partitioned, which pdqSort takes as a hint that it may be sorted.
+Parameters: Range [first, last) and the less-than.
+Return: Final position of the pivot, and whether no entries were swapped.
+*/
+template <class It, class Less>
+pair<It, bool> pdqPartitionRight(It first, It last, const Less &less) {
+  auto pivot = std::move(*first);
+  It i = first, j = last;
+  while (less(*++i, pivot))
+    ;
+  if (i - 1 == first)
+    while (i < j && !less(*--j, pivot))
+      ;
+  else
+    while (!less(*--j, pivot))
+      ;
+
+  bool alreadyPartitioned = i >= j;
+  while (i < j) {
+    iter_swap(i, j);
+    while (less(*++i, pivot))
+      ;
+    while (!less(*--j, pivot))
+      ;
+  }
+
+  It pivotPos = i - 1;
+  *first = std::move(*pivotPos);
+  *pivotPos = std::move(pivot);
+  return make_pair(pivotPos, alreadyPartitioned);
+}
+
+/*
+Description: Branchless version of pdqPartitionRight, after BlockQuicksort
+(see blockPartition). Blocks of PDQ_BLOCK entries at each end are
+classified against the pivot with an unconditional offset write and a
+conditional increment, then misplaced pairs are exchanged with a cyclic
+permutation, which needs fewer moves than swapping them.
+Parameters: Range [first, last) and the less-than.
+Return: Final position of the pivot, and whether no entries were swapped.
+*/
+template <class It, class Less>
+pair<It, bool> pdqPartitionRightBranchless(It first, It last,
+                                           const Less &less) {
+  auto pivot = std::move(*first);
+  It i = first, j = last;
+  while (less(*++i, pivot))
+    ;
+  if (i - 1 == first)
+    while (i < j && !less(*--j, pivot))
+      ;
+  else
+    while (!less(*--j, pivot))
+      ;
+
+  bool alreadyPartitioned = i >= j;
+  if (!alreadyPartitioned) {
+    iter_swap(i, j);
+    ++i;
+
+    alignas(64) unsigned char offsetsL[PDQ_BLOCK], offsetsR[PDQ_BLOCK];
+    It baseL = i, baseR = j;
+    size_t numL = 0, numR = 0, startL = 0, startR = 0;
+    while (i < j) {
+      size_t unknown = j - i;
+      size_t splitL = numL == 0 ? (numR == 0 ? unknown / 2 : unknown) : 0;
+      size_t splitR = numR == 0 ? unknown - splitL : 0;
+      splitL = min(splitL, static_cast<size_t>(PDQ_BLOCK));
+      splitR = min(splitR, static_cast<size_t>(PDQ_BLOCK));
+
+      for (size_t k = 0; k < splitL; k++) {
+        offsetsL[numL] = k;
+        numL += !less(*i, pivot);
+        ++i;
+      }
+      for (size_t k = 0; k < splitR;) {
+        offsetsR[numR] = ++k;
+        numR += less(*--j, pivot);
+      }
+
+      size_t num = min(numL, numR);
+      if (num > 0) {
+        It l = baseL + offsetsL[startL];
+        It r = baseR - offsetsR[startR];
+        auto tmp = std::move(*l);
+        *l = std::move(*r);
+        for (size_t k = 1; k < num; k++) {
+          l = baseL + offsetsL[startL + k];
+          *r = std::move(*l);
+          r = baseR - offsetsR[startR + k];
+          *l = std::move(*r);
+        }
+        *r = std::move(tmp);
+      }
+
+      numL -= num;
+      numR -= num;
+      startL += num;
+      startR += num;
+      if (numL == 0) {
+        startL = 0;
+        baseL = i;
+      }
+      if (numR == 0) {
+        startR = 0;
+        baseR = j;
+      }
+    }
+
+    // One side may still hold misplaced entries; move them to the middle.
+    if (numL > 0) {
+      while (numL-- > 0)
+        iter_swap(baseL + offsetsL[startL + numL], --j);
+      i = j;
+    }
+    if (numR > 0) {
+      while (numR-- > 0) {
+        iter_swap(baseR - offsetsR[startR + numR], i);
+        ++i;
+      }
+    }
+  }
+
+  It pivotPos = i - 1;
+  *first = std::move(*pivotPos);
+  *pivotPos = std::move(pivot);
+  return make_pair(pivotPos, alreadyPartitioned);
+}
+
+/*
+Description: Partitions around the pivot at *first, sending entries equal
+to it left. pdqSort only calls this when the pivot equals the entry just
+before the range, which is not greater than anything in it, so every entry
+that goes left equals the pivot and is already in its final place.
+Parameters: Range [first, last) and the less-than.
+Return: Final position of the pivot.
+*/
+template <class It, class Less>
+It pdqPartitionLeft(It first, It last, const Less &less) {
+  auto pivot = std::move(*first);
+  It i = first, j = last;
+  while (less(pivot, *--j))
+    ;
+  if (j + 1 == last)
+    while (i < j && !less(pivot, *++i))
+      ;
+  else
+    while (!less(pivot, *++i))
+      ;
+
+  while (i < j) {
+    iter_swap(i, j);
+    while (less(pivot, *--j))
+      ;
+    while (!less(pivot, *++i))
+      ;
+  }
+
+  *first = std::move(*j);
+  *j = std::move(pivot);
+  return j;
+}
+
+/*
+Description: Recursive portion of pdqSort (Orson Peters, pattern-defeating
+quicksort). Each pass picks a median of three, or a ninther for large
+ranges, and then:
+- if the pivot equals the entry before the range, the keys equal to it are
+split off with pdqPartitionLeft and left alone, so a range with few
+distinct keys is done after one pass per key;
+- otherwise the range is partitioned, and a partition that swapped nothing
+is finished with a partial insertion sort that gives up quickly if the
+range was not nearly sorted;
+- a partition leaving less than an eighth on one side is counted as bad and
+breaks up the pattern by swapping a few entries on each side, and once
+badAllowed runs out the range goes to heapsort.
+Recurses into the left side and loops on the right one; with a task group,
+left sides above PDQ_PARALLEL_CUTOFF are handed to the pool instead.
+Parameters: Range [first, last), the less-than, bad partitions left before
+heapsort, whether the range is the leftmost one (nothing before it can be
+read), and the task group (nullptr to stay on this thread).
+Return: None
+Notes: The less-than is shared by reference with the tasks, so it must be
+safe to call from several threads at once.
+*/
+template <bool Branchless, class It, class Less>
+void pdqSort(It first, It last, const Less &less, int badAllowed,
+             bool leftmost, TaskGroup *group) {
+  typedef typename iterator_traits<It>::difference_type Diff;
+  while (true) {
+    Diff size = last - first;
+    if (size < PDQ_INSERTION_THRESHOLD) {
+      if (leftmost)
+        pdqInsertion(first, last, less);
+      else
+        pdqUnguardedInsertion(first, last, less);
+      return;
+    }
+
+    Diff half = size / 2;
+    if (size > NINTHER_THRESHOLD) {
+      pdqSort3(first, first + half, last - 1, less);
+      pdqSort3(first + 1, first + (half - 1), last - 2, less);
+      pdqSort3(first + 2, first + (half + 1), last - 3, less);
+      pdqSort3(first + (half - 1), first + half, first + (half + 1), less);
+      iter_swap(first, first + half);
+    } else {
+      pdqSort3(first + half, first, last - 1, less);
+    }
+
+    if (!leftmost && !less(*(first - 1), *first)) {
+      first = pdqPartitionLeft(first, last, less) + 1;
+      continue;
+    }
+
+    pair<It, bool> cut = Branchless
+                             ? pdqPartitionRightBranchless(first, last, less)
+                             : pdqPartitionRight(first, last, less);
+    It pivotPos = cut.first;
+    Diff sizeL = pivotPos - first;
+    Diff sizeR = last - (pivotPos + 1);
+
+    if (sizeL < size / 8 || sizeR < size / 8) {
+      if (--badAllowed == 0) {
+        pdqHeapsort(first, last, less);
+        return;
+      }
+      if (sizeL >= PDQ_INSERTION_THRESHOLD) {
+        iter_swap(first, first + sizeL / 4);
+        iter_swap(pivotPos - 1, pivotPos - sizeL / 4);
+        if (sizeL > NINTHER_THRESHOLD) {
+          iter_swap(first + 1, first + (sizeL / 4 + 1));
+          iter_swap(first + 2, first + (sizeL / 4 + 2));
+          iter_swap(pivotPos - 2, pivotPos - (sizeL / 4 + 1));
+          iter_swap(pivotPos - 3, pivotPos - (sizeL / 4 + 2));
+        }
+      }
+      if (sizeR >= PDQ_INSERTION_THRESHOLD) {
+        iter_swap(pivotPos + 1, pivotPos + (1 + sizeR / 4));
+        iter_swap(last - 1, last - sizeR / 4);
+        if (sizeR > NINTHER_THRESHOLD) {
+          iter_swap(pivotPos + 2, pivotPos + (2 + sizeR / 4));
+          iter_swap(pivotPos + 3, pivotPos + (3 + sizeR / 4));
+          iter_swap(last - 2, last - (1 + sizeR / 4));
+          iter_swap(last - 3, last - (2 + sizeR / 4));
+        }
+      }
+    } else if (cut.second && pdqPartialInsertion(first, pivotPos, less) &&
+               pdqPartialInsertion(pivotPos + 1, last, less)) {
+      return;
+    }
+
+    if (group != nullptr && static_cast<size_t>(sizeL) > PDQ_PARALLEL_CUTOFF)
+      group->run([=, &less]() {
+        pdqSort<Branchless>(first, pivotPos, less, badAllowed, leftmost,
+                            group);
+      });
+    else
+      pdqSort<Branchless>(first, pivotPos, less, badAllowed, leftmost, group);
+    first = pivotPos + 1;
+    leftmost = false;
+  }
+}
+
+/*
+Description: Sorts [first, last) with pdqSort, on a pool of threads threads
+when there is more than one and the range is large enough to split.
+Parameters: Range [first, last), the less-than and the number of threads.
+Return: None
+Notes: Not stable. Up to log2(size) bad partitions are allowed before
+heapsort takes over, which keeps the worst case at O(n log n).
+*/
+template <bool Branchless, class It, class Less>
+void pdqSort(It first, It last, const Less &less, int threads) {
+  size_t n = last - first;
+  int badAllowed = 0;
+  for (size_t m = n; m > 1; m /= 2)
+    badAllowed++;
+
+  if (threads > 1 && n > PDQ_PARALLEL_CUTOFF) {
+    WorkStealingPool pool(threads);
+    TaskGroup group(pool);
+    pdqSort<Branchless>(first, last, less, badAllowed, true, &group);
+    group.wait();
+    return;
+  }
+  pdqSort<Branchless>(first, last, less, badAllowed, true,
+                      static_cast<TaskGroup *>(nullptr));
+}
+
+/*
+Description: Sorts the array using pattern-defeating quicksort, with the
+branchless partition for arithmetic types.
+Parameters: Array A and size of the array.
+Return: None
+*/
+template <class T> void pdqSort(T A[], int size) {
+  pdqSort<pdqBranchless<less<T>, T>::value>(A, A + size, less<T>(), 1);
+}
+
+///////////////////////////////////////////////////////////
+//  Sample Sort: parallel distribution sort for large arrays
+///////////////////////////////////////////////////////////
+
+// Arrays at or below this size are sorted by the serial pdqSort.
+const int SAMPLE_SORT_CUTOFF = 1 << 16;
+const int SAMPLE_SORT_LOG_BUCKETS = 8;
+const int SAMPLE_SORT_BUCKETS = 1 << SAMPLE_SORT_LOG_BUCKETS;
+// Sample entries drawn per bucket when choosing the splitters.
+const int SAMPLE_OVERSAMPLING = 16;
+
+/*
+Description: Splitters of the sample sort stored as an implicit binary search
+tree (Eytzinger layout: node j has children 2j and 2j + 1). Classifying an
+entry is SAMPLE_SORT_LOG_BUCKETS steps of j = 2j + (tree[j] < x), with no
+branch that depends on the data.
+*/
+template <class T> struct SplitterTree {
+  vector<T> tree;
+
+  explicit SplitterTree(const T splitters[]) : tree(SAMPLE_SORT_BUCKETS) {
+    build(splitters, 1, 0, SAMPLE_SORT_BUCKETS - 1);
+  }
+
+  void build(const T splitters[], int j, int lo, int hi) {
+    if (j >= SAMPLE_SORT_BUCKETS)
+      return;
+    int mid = (lo + hi) / 2;
+    tree[j] = splitters[mid];
+    build(splitters, 2 * j, lo, mid);
+    build(splitters, 2 * j + 1, mid + 1, hi);
+  }
+
+  int classify(const T &x) const {
+    int j = 1;
+    for (int level = 0; level < SAMPLE_SORT_LOG_BUCKETS; level++)
+      j = 2 * j + (tree[j] < x);
+    return j - SAMPLE_SORT_BUCKETS;
+  }
+};
+
+/*
+Description: Sorts the array using a parallel sample sort. The splitters are
+every SAMPLE_OVERSAMPLING-th entry of a sorted random sample. The array is
+cut into one block per thread, and each thread classifies its block through
+the splitter tree, remembering every entry's bucket and counting the bucket
+sizes. The per-thread counts give every thread its own write position in
+each bucket, so the blocks are scattered into a temp array without locking.
+The buckets are then sorted concurrently by pdqSort and copied back.
+Parameters: Array A, size of the array and the number of threads to use.
+Return: None
+Notes: One thread (or a small array) runs pdqSort(A, size), which keeps the
+worst case at O(n log n) for every T. Keys equal to a splitter all land in
+one bucket, so heavily duplicated keys cost parallelism but not correctness.
+*/
+template <class T> void sampleSort(T A[], int size, int threads) {
+  if (size < 2)
+    return;
+  if (threads <= 1 || size <= SAMPLE_SORT_CUTOFF) {
+    pdqSort(A, size);
+    return;
+  }
+
+  int sampleSize = SAMPLE_SORT_BUCKETS * SAMPLE_OVERSAMPLING;
+  vector<T> sample(sampleSize);
+  mt19937 generator(size);
+  uniform_int_distribution<int> position(0, size - 1);
+  for (int i = 0; i < sampleSize; i++)
+    sample[i] = A[position(generator)];
+  introSort(sample.data(), sampleSize);
+
+  vector<T> splitters(SAMPLE_SORT_BUCKETS - 1);
+  for (int i = 0; i < SAMPLE_SORT_BUCKETS - 1; i++)
+    splitters[i] = sample[(i + 1) * SAMPLE_OVERSAMPLING - 1];
+  SplitterTree<T> tree(splitters.data());
+
+  WorkStealingPool pool(threads);
+  TaskGroup group(pool);
+  vector<unsigned char> bucketOf(size);
+  vector<vector<int>> counts(threads, vector<int>(SAMPLE_SORT_BUCKETS));
+  auto blockStart = [=](int t) {
+    return static_cast<int>(static_cast<long long>(size) * t / threads);
+  };
+
+  for (int t = 0; t < threads; t++)
+    group.run([&, t]() {
+      vector<int> &count = counts[t];
+      for (int i = blockStart(t); i < blockStart(t + 1); i++) {
+        int b = tree.classify(A[i]);
+        bucketOf[i] = static_cast<unsigned char>(b);
+        count[b]++;
+      }
+    });
+  group.wait();
+
+  // turn the counts into write positions: bucket-major, then thread order
+  vector<int> bucketStart(SAMPLE_SORT_BUCKETS + 1);
+  int sum = 0;
+  for (int b = 0; b < SAMPLE_SORT_BUCKETS; b++) {
+    bucketStart[b] = sum;
+    for (int t = 0; t < threads; t++) {
+      int count = counts[t][b];
+      counts[t][b] = sum;
+      sum += count;
+    }
+  }
+  bucketStart[SAMPLE_SORT_BUCKETS] = sum;
+
+  T *Temp = new T[size];
+  for (int t = 0; t < threads; t++)
+    group.run([&, t]() {
+      vector<int> &next = counts[t];
+      for (int i = blockStart(t); i < blockStart(t + 1); i++)
+        Temp[next[bucketOf[i]]++] = A[i];
+    });
+  group.wait();
+
+  for (int b = 0; b < SAMPLE_SORT_BUCKETS; b++)
+    group.run([&, b]() {
+      int start = bucketStart[b];
+      int length = bucketStart[b + 1] - start;
+      if (length > 1)
+        pdqSort(Temp + start, length);
+      copy(Temp + start, Temp + start + length, A + start);
+    });
+  group.wait();
+
+  delete[] Temp;
+}
+
+///////////////////////////////////////////////////////////
+//  Comb Sort
+///////////////////////////////////////////////////////////
+
+// Each comb sort gap is the previous one divided by this.
+const double COMB_SHRINK = 1.3;
+
+/*
+Description: Sorts the array using comb sort. Each pass compare-exchanges
+entries a gap apart, with the gap shrinking by COMB_SHRINK and 9 and 10
+replaced by 11 (Combsort11), and the passes use SIMD min/max for int, float
+and double once the gap is a register wide. The bubble sort that used to
+finish the sort is replaced by insertion sort, which is close to linear on
+what the gap passes leave.
+Parameters: Array A and size of the array.
+Return: None
+*/
+template <class T> void combsort(T data[], const int n) {
+  int step = n;
+  while ((step = int(step / COMB_SHRINK)) > 1) {
+    if (step == 9 || step == 10)
+      step = 11;
+    if (simdGapPass(data, n, step))
+      continue;
+    for (int j = 0; j + step < n; j++)
+      if (data[j + step] < data[j])
+        swap(data[j], data[j + step]);
+  }
+
+  insertion(data, n);
+}
+
+///////////////////////////////////////////////////////////
+//  Shell Sort
+///////////////////////////////////////////////////////////
+
+/*
+Description: Gap sequences for Shellsort:
+- SHELL_KNUTH: 1, 4, 13, 40, ... (3h + 1), the original sequence.
+- SHELL_CIURA: 1, 4, 10, 23, 57, 132, 301, 701, 1750 (found empirically by
+Ciura), extended by a factor of 2.25.
+- SHELL_TOKUDA: ceil((9 * 2.25^k - 4) / 5), 1, 4, 9, 20, 46, 103, ...
+- SHELL_SEDGEWICK: 4^k + 3 * 2^(k - 1) + 1 after 1, 1, 8, 23, 77, 281, ...
+*/
+enum ShellGaps : int { SHELL_KNUTH, SHELL_CIURA, SHELL_TOKUDA, SHELL_SEDGEWICK };
+
+/*
+Description: Lists the gaps of a sequence that are less than n.
+Parameters: Gap sequence and size of the array.
+Return: The gaps in increasing order, starting with 1.
+Notes: Gaps are computed in 64 bits, so no gap overflows for any int n.
+*/
+inline vector<int> shellGaps(ShellGaps sequence, int n) {
+  static const long long ciura[] = {1, 4, 10, 23, 57, 132, 301, 701, 1750};
+  vector<int> gaps;
+  for (int k = 0;; k++) {
+    long long h;
+    switch (sequence) {
+    case SHELL_CIURA:
+      h = k < 9 ? ciura[k] : static_cast<long long>(gaps.back() * 2.25);
+      break;
+    case SHELL_TOKUDA:
+      h = static_cast<long long>(ceil((9 * pow(2.25, k) - 4) / 5));
+      break;
+    case SHELL_SEDGEWICK:
+      h = k == 0 ? 1 : (1LL << (2 * k)) + 3 * (1LL << (k - 1)) + 1;
+      break;
+    default:
+      h = k == 0 ? 1 : 3LL * gaps.back() + 1;
+    }
+    if (h >= n && k > 0)
+      break;
+    gaps.push_back(static_cast<int>(h));
+  }
+  return gaps;
+}
+
+/*
+Description: Sorts the array using Shell sort, with one gapped insertion
+sort pass per gap from the largest down to 1.
+Parameters: Array A, size of the array, and the gap sequence (Ciura's when
+left out).
+Return: None
+*/
+template <class T> void Shellsort(T data[], int n, ShellGaps sequence) {
+  vector<int> gaps = shellGaps(sequence, n);
+  for (int g = gaps.size() - 1; g >= 0; g--) {
+    int h = gaps[g];
+    for (int j = h; j < n; j++) {
+      T tmp = data[j];
+      int k = j;
+      while (k - h >= 0 && tmp < data[k - h]) {
+        data[k] = data[k - h];
+        k -= h;
+      }
+      data[k] = tmp;
+    }
+  }
+}
+
+template <class T> void Shellsort(T data[], int n) {
+  Shellsort(data, n, SHELL_CIURA);
+}
+
+///////////////////////////////////////////////////////////
+//  Heap Sort
+///////////////////////////////////////////////////////////
+
+/*
+Description: Restores the heap property on the array segment.
+Parameters: Array A and the first and last index to restore.
+Return: None
+*/
+template <class T> void moveDown(T data[], int first, int last) {
+  int largest = 2 * first + 1;
+  while (largest <= last) {
+    if (largest < last && // first has two children (at 2*first+1 and
+        data[largest] < data[largest + 1]) // 2*first+2) and the second
+      largest++;                           // is larger than the first;
+
+    if (data[first] < data[largest]) {  // if necessary,
+      swap(data[first], data[largest]); // swap child and parent,
+      first = largest;                  // and move down;
+      largest = 2 * first + 1;
+    } else
+      largest = last + 1; // to exit the loop: the heap property
+  }                       // isn't violated by data[first];
+}
+
+/*
+Description: Sorts the array using the standard heap sort on a binary heap.
+Parameters: Array A and size of the array.
+Return: None
+Notes: Kept for comparison with the d-ary heapsort below.
+*/
+template <class T> void binaryHeapsort(T data[], const int n) {
+  int i;
+  for (i = n / 2 - 1; i >= 0; --i) // create the heap;
+    moveDown(data, i, n - 1);
+  for (i = n - 1; i >= 1; --i) {
+    swap(data[0], data[i]);   // move the largest item to data[i];
+    moveDown(data, 0, i - 1); // restore the heap property;
+  }
+}
+
+/*
+Description: Hints the CPU to start loading an address into the cache.
+Parameters: Address that will be read soon.
+Return: None
+*/
+inline void prefetchRead(const void *address) {
+#if defined(__GNUC__)
+  __builtin_prefetch(address, 0, 3);
+#else
+  (void)address;
+#endif
+}
+
+/*
+Description: Bottom-up sift-down in a D-ary heap (children of i at D*i + 1
+through D*i + D). The hole at first is first moved down to a leaf, always
+taking the largest child and never comparing against value, and value is
+then bubbled up from the leaf. Since value usually belongs near the bottom,
+this needs about half the comparisons of the usual sift-down. At every level
+the grandchildren of the hole are prefetched, so their cache misses overlap
+with the comparisons among the children.
+Parameters: Heap array, position of the hole, heap size and the value to
+place.
+Return: None
+*/
+template <int D, class T>
+void dAryMoveDown(T data[], int first, int n, const T &value) {
+  const int lineEntries = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+  int hole = first;
+
+  while (true) {
+    // child and grandchild indices are wider than int so they cannot
+    // overflow near the end of a heap of INT_MAX entries
+    long long wideChild = D * static_cast<long long>(hole) + 1;
+    if (wideChild >= n)
+      break;
+    int child = static_cast<int>(wideChild);
+
+    long long grandchild = D * wideChild + 1;
+    long long grandEnd = min(grandchild + D * D, static_cast<long long>(n));
+    for (long long g = grandchild; g < grandEnd; g += lineEntries)
+      prefetchRead(data + g);
+
+    // a full group of D children is compared with a fixed trip count
+    int largest = child;
+    if (wideChild + D <= n)
+      for (int c = 1; c < D; c++)
+        largest = data[largest] < data[child + c] ? child + c : largest;
+    else
+      for (int c = child + 1; c < n; c++)
+        largest = data[largest] < data[c] ? c : largest;
+
+    data[hole] = data[largest];
+    hole = largest;
+  }
+
+  while (hole > first) {
+    int parent = (hole - 1) / D;
+    if (!(data[parent] < value))
+      break;
+    data[hole] = data[parent];
+    hole = parent;
+  }
+  data[hole] = value;
+}
+
+/*
+Description: Sorts the array using a heap sort on a D-ary heap. A wider heap
+is log2(D) times shallower than a binary one and the D children of a node
+are adjacent, so each level of a sift costs one or two cache lines instead
+of a cache line per binary level once the heap outgrows the caches.
+Parameters: Array A and size of the array.
+Return: None
+*/
+template <int D, class T> void dAryHeapsort(T data[], const int n) {
+  if (n < 2)
+    return;
+
+  for (int i = (n - 2) / D; i >= 0; i--) { // create the heap;
+    T value = data[i];
+    dAryMoveDown<D>(data, i, n, value);
+  }
+  for (int i = n - 1; i >= 1; i--) { // move the largest item to data[i];
+    T value = data[i];
+    data[i] = data[0];
+    dAryMoveDown<D>(data, 0, i, value);
+  }
+}
+
+/*
+Description: Sorts the array using heap sort.
+Parameters: Array A and size of the array.
+Return: None
+Notes: Uses the 4-ary bottom-up heap; binaryHeapsort is the original.
+*/
+template <class T> void heapsort(T data[], const int n) {
+  dAryHeapsort<4>(data, n);
+}
+
+///////////////////////////////////////////////////////////
+//  Selection: nth element, partial sort and top-k
+///////////////////////////////////////////////////////////
+
+// Ranges above this size pick their pivot from a Floyd-Rivest sample.
+const int SELECT_SAMPLE_CUTOFF = 600;
+// Arrays of at most this size are scanned for top-k by one thread.
+const int TOP_K_PARALLEL_CUTOFF = 1 << 16;
+
+/*
+Description: Recursive portion of nthElement (Floyd and Rivest, "Algorithm
+489: SELECT"). Large ranges first select within a small window around
+where the kth entry should fall in a sample, so that A[k] is a pivot very
+close to the final kth entry and one partition removes almost the whole
+range. The loop is bounded like introSort: once the depth limit is used up
+the remaining range is sorted.
+Parameters: Array A, starting and ending positions of the range, position
+k to select and the number of partitioning levels left.
+Return: None
+*/
+template <class T>
+void floydRivestSelect(T A[], int left, int right, int k, int depthLimit) {
+  while (right > left) {
+    if (depthLimit == 0) {
+      introSort(A + left, right - left + 1);
+      return;
+    }
+    depthLimit--;
+
+    if (right - left > SELECT_SAMPLE_CUTOFF) {
+      double n = right - left + 1;
+      double i = k - left + 1;
+      double z = log(n);
+      double s = 0.5 * exp(2 * z / 3);
+      double sd = 0.5 * sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1 : 1);
+      int sampleLeft = max(left, static_cast<int>(k - i * s / n + sd));
+      int sampleRight = min(right, static_cast<int>(k + (n - i) * s / n + sd));
+      floydRivestSelect(A, sampleLeft, sampleRight, k, depthLimit);
+    }
+
+    int i, j;
+    quickPartition(A, left, right, A[k], i, j);
+    if (k <= j)
+      right = j;
+    else if (k >= i)
+      left = i;
+    else
+      return; // A[k] is among the entries equal to the pivot
+  }
+}
+
+/*
+Description: Rearranges the array so that A[k] is the entry that would be
+there if the array were sorted, with nothing greater before it and nothing
+smaller after it.
+Parameters: Array A, size of the array and the position to select.
+Return: None
+Notes: Expected linear time; the depth limit of 2*log2(size) bounds the
+worst case at O(n log n).
+*/
+template <class T> void nthElement(T A[], int size, int k) {
+  if (k < 0 || k >= size)
+    return;
+
+  int depthLimit = 0;
+  for (int n = size; n > 1; n /= 2)
+    depthLimit += 2;
+
+  floydRivestSelect(A, 0, size - 1, k, depthLimit);
+}
+
+/*
+Description: Sorts the k smallest entries of the array into A[0 .. k - 1].
+The first k entries are made into a max-heap with moveDown; every later
+entry smaller than the heap's root replaces it, and the heap is sorted at
+the end, for O(n log k) time.
+Parameters: Array A, size of the array and k.
+Return: None
+Notes: The order of A[k .. size - 1] is unspecified.
+*/
+template <class T> void partialSort(T A[], int size, int k) {
+  k = min(k, size);
+  if (k < 1)
+    return;
+
+  for (int i = k / 2 - 1; i >= 0; --i)
+    moveDown(A, i, k - 1);
+
+  for (int i = k; i < size; i++)
+    if (A[i] < A[0]) {
+      swap(A[0], A[i]);
+      moveDown(A, 0, k - 1);
+    }
+
+  for (int i = k - 1; i >= 1; --i) {
+    swap(A[0], A[i]);
+    moveDown(A, 0, i - 1);
+  }
+}
+
+/*
+Description: Streaming selection of the k smallest entries seen so far. The
+entries are kept in a max-heap of at most k entries, so input can be fed in
+chunks of any size with O(k) memory.
+*/
+template <class T> class TopK {
+public:
+  explicit TopK(int k) : k(max(k, 0)) { heap.reserve(this->k); }
+
+  void add(const T &x);
+  void add(const T chunk[], int n) {
+    for (int i = 0; i < n; i++)
+      add(chunk[i]);
+  }
+  void merge(const TopK &other) { add(other.heap.data(), other.heap.size()); }
+
+  vector<T> result() const;
+
+private:
+  int k;
+  vector<T> heap;
+};
+
+/*
+Description: Offers one entry. Until the heap holds k entries it is pushed
+and moved up; after that it replaces the root when it is smaller.
+Parameters: Entry.
+Return: None
+*/
+template <class T> void TopK<T>::add(const T &x) {
+  int size = heap.size();
+  if (size < k) {
+    heap.push_back(x);
+    int child = size;
+    while (child > 0 && heap[(child - 1) / 2] < heap[child]) {
+      swap(heap[(child - 1) / 2], heap[child]);
+      child = (child - 1) / 2;
+    }
+  } else if (size > 0 && x < heap[0]) {
+    heap[0] = x;
+    moveDown(heap.data(), 0, size - 1);
+  }
+}
+
+/*
+Description: The k smallest entries seen so far.
+Parameters: None
+Return: The entries in ascending order.
+*/
+template <class T> vector<T> TopK<T>::result() const {
+  vector<T> sortedHeap = heap;
+  for (int i = static_cast<int>(sortedHeap.size()) - 1; i >= 1; --i) {
+    swap(sortedHeap[0], sortedHeap[i]);
+    moveDown(sortedHeap.data(), 0, i - 1);
+  }
+  return sortedHeap;
+}
+
+/*
+Description: Finds the k smallest entries of the array. With threads every
+thread runs a TopK over its block, and the per-thread heaps are merged.
+Parameters: Array A, size of the array, k and the number of threads.
+Return: The k smallest entries in ascending order.
+Notes: The array is not modified.
+*/
+template <class T>
+vector<T> topK(const T A[], int size, int k, int threads) {
+  if (threads <= 1 || size <= TOP_K_PARALLEL_CUTOFF) {
+    TopK<T> best(k);
+    best.add(A, size);
+    return best.result();
+  }
+
+  WorkStealingPool pool(threads);
+  TaskGroup group(pool);
+  vector<TopK<T>> partial(threads, TopK<T>(k));
+  for (int t = 0; t < threads; t++)
+    group.run([&, t]() {
+      long long first = static_cast<long long>(size) * t / threads;
+      long long last = static_cast<long long>(size) * (t + 1) / threads;
+      partial[t].add(A + first, static_cast<int>(last - first));
+    });
+  group.wait();
+
+  for (int t = 1; t < threads; t++)
+    partial[0].merge(partial[t]);
+  return partial[0].result();
+}
+
+///////////////////////////////////////////////////////////
+//  Radix Sort: implementation for integer data.
+///////////////////////////////////////////////////////////
+
+/*
+Description: Maps an integer to an unsigned key with the same ordering by
+flipping the sign bit of signed types.
+Parameters: Integer value.
+Return: Unsigned key.
+*/
+template <class T> typename make_unsigned<T>::type radixKey(T x) {
+  typedef typename make_unsigned<T>::type U;
+  U key = static_cast<U>(x);
+  if (is_signed<T>::value)
+    key ^= U(1) << (sizeof(T) * 8 - 1);
+  return key;
+}
+
+/*
+Description: Least significant digit radix sort on digits of digitBits bits.
+One pass over the data builds the histograms of every digit, then each digit
+is scattered from the source buffer into the destination buffer using the
+prefix sums of its histogram, swapping the two buffers after each pass.
+Passes where every key has the same digit are skipped.
+Parameters: Array data, size of the array, bits per digit (8, 11 and 16 are
+the useful sizes), and an optional scratch buffer of size n.
+Return: None
+Notes: This is for integer data only, signed or unsigned, of any width. When
+no scratch buffer is passed one is allocated for the call.
+*/
+template <class T>
+void lsdRadixSort(T data[], long n, int digitBits, T scratch[]) {
+  static_assert(is_integral<T>::value, "lsdRadixSort needs integer keys");
+  typedef typename make_unsigned<T>::type U;
+
+  if (n < 2)
+    return;
+
+  const int keyBits = sizeof(T) * 8;
+  const int passes = (keyBits + digitBits - 1) / digitBits;
+  const long buckets = 1L << digitBits;
+  const U mask = static_cast<U>(buckets - 1);
+
+  vector<long> counts(passes * buckets, 0);
+  for (long i = 0; i < n; i++) {
+    U key = radixKey(data[i]);
+    for (int p = 0; p < passes; p++)
+      counts[p * buckets + ((key >> (p * digitBits)) & mask)]++;
+  }
+
+  T *buffer = scratch != nullptr ? scratch : new T[n];
+  T *src = data;
+  T *dst = buffer;
+
+  for (int p = 0; p < passes; p++) {
+    int shift = p * digitBits;
+    long *offsets = &counts[p * buckets];
+    if (offsets[(radixKey(src[0]) >> shift) & mask] == n)
+      continue; // every key has the same digit
+
+    long sum = 0;
+    for (long b = 0; b < buckets; b++) {
+      long count = offsets[b];
+      offsets[b] = sum;
+      sum += count;
+    }
+
+    for (long i = 0; i < n; i++)
+      dst[offsets[(radixKey(src[i]) >> shift) & mask]++] = src[i];
+
+    swap(src, dst);
+  }
+
+  if (src != data)
+    copy(src, src + n, data);
+
+  if (scratch == nullptr)
+    delete[] buffer;
+}
+
+/*
+Description: Order-preserving map between IEEE-754 bit patterns and unsigned
+keys. Positive values get the sign bit set and negative values have every
+bit flipped, so the keys order as -inf < negatives < -0.0 < +0.0 <
+positives < +inf. A NaN is mapped as if its sign bit were clear, which puts
+every NaN after +inf.
+*/
+template <class T> struct FloatRadixKey;
+
+template <> struct FloatRadixKey<float> {
+  typedef uint32_t U;
+};
+
+template <> struct FloatRadixKey<double> {
+  typedef uint64_t U;
+};
+
+template <class U> U floatToKey(U bits, bool isNaN) {
+  const U sign = U(1) << (sizeof(U) * 8 - 1);
+  if (isNaN)
+    bits &= ~sign;
+  return (bits & sign) ? ~bits : bits | sign;
+}
+
+template <class U> U keyToFloat(U key) {
+  const U sign = U(1) << (sizeof(U) * 8 - 1);
+  return (key & sign) ? key & ~sign : ~key;
+}
+
+/*
+Description: Sorts float or double data with lsdRadixSort on the
+order-preserving keys of their bit patterns, then maps the keys back.
+Parameters: Array A, size of the array, and bits per digit (8 or 11).
+Return: None
+Notes: -0.0 sorts before +0.0, and NaNs sort last. A negative NaN comes
+back with its sign bit cleared; its payload is kept.
+*/
+template <class T> void floatRadixSort(T A[], long n, int digitBits) {
+  static_assert(is_floating_point<T>::value && sizeof(T) <= 8,
+                "floatRadixSort needs float or double keys");
+  typedef typename FloatRadixKey<T>::U U;
+
+  if (n < 2)
+    return;
+
+  vector<U> keys(n);
+  memcpy(keys.data(), A, n * sizeof(T));
+  for (long i = 0; i < n; i++)
+    keys[i] = floatToKey(keys[i], A[i] != A[i]);
+
+  lsdRadixSort(keys.data(), n, digitBits);
+
+  for (long i = 0; i < n; i++)
+    keys[i] = keyToFloat(keys[i]);
+  memcpy(A, keys.data(), n * sizeof(T));
+}
+
+/*
+Description: Sorts the array using radix sort.
+Parameters: Array A, size of the array, and radix to use.
+Return: None
+Notes: This is for integer, float and double data. The radix is rounded up
+to a digit of 8, 11 or 16 bits (radix 256, 2048 or 65536) and the work is
+done by lsdRadixSort, or floatRadixSort for floating point data.
+*/
+template <class T> void radixsort(T data[], const int n, const int radix) {
+  int digitBits = 8;
+  if (radix > 256)
+    digitBits = 11;
+  if (radix > 2048)
+    digitBits = 16;
+
+  if constexpr (is_floating_point<T>::value)
+    floatRadixSort(data, n, digitBits);
+  else
+    lsdRadixSort(data, n, digitBits);
+}
+
+///////////////////////////////////////////////////////////
+//  MSD Radix Sort: American flag sort for integer and string data.
+///////////////////////////////////////////////////////////
+
+// Buckets at or below this size are finished with a comparison sort.
+const long MSD_RADIX_SMALL = 64;
+// Buckets above this size are sorted as separate tasks on the pool.
+const long MSD_PARALLEL_CUTOFF = 1 << 14;
+
+/*
+Description: Digit extraction for the MSD radix sort. Integer keys are split
+into bytes starting from the most significant one, and a bucket is finished
+once its last byte has been used.
+*/
+template <class T> struct MsdRadixDigits {
+  static const int buckets = 256;
+
+  static int digit(const T &x, int level) {
+    return (radixKey(x) >> ((sizeof(T) - 1 - level) * 8)) & 0xFF;
+  }
+
+  static bool finished(int, int level) {
+    return level + 1 >= static_cast<int>(sizeof(T));
+  }
+};
+
+/*
+Description: Digit extraction for string keys. The digit at a depth is the
+character there plus one, and 0 once the string has ended, so shorter strings
+sort first and bucket 0 needs no further sorting.
+*/
+template <> struct MsdRadixDigits<string> {
+  static const int buckets = 257;
+
+  static int digit(const string &x, int level) {
+    if (level < static_cast<int>(x.size()))
+      return static_cast<unsigned char>(x[level]) + 1;
+    return 0;
+  }
+
+  static bool finished(int bucket, int) { return bucket == 0; }
+};
+
+/*
+Description: Recursive portion of the MSD radix sort. Counts the digits at
+the current level, permutes the elements into their buckets in place by
+following swap cycles (American flag sort), then sorts every bucket on the
+next digit. Levels where all keys share a digit are skipped without moving
+anything, and large buckets are handed to the pool when there is one.
+Parameters: Array A, size of the array, digit level, and the pool to run
+buckets on (nullptr to stay on the calling thread).
+Return: None
+*/
+template <class T>
+void msdRadixSort(T A[], long n, int level, WorkStealingPool *pool) {
+  typedef MsdRadixDigits<T> Digits;
+  vector<long> counts(Digits::buckets), next(Digits::buckets),
+      ends(Digits::buckets);
+
+  while (true) {
+    if (n <= MSD_RADIX_SMALL) {
+      introSort(A, static_cast<int>(n));
+      return;
+    }
+
+    fill(counts.begin(), counts.end(), 0);
+    for (long i = 0; i < n; i++)
+      counts[Digits::digit(A[i], level)]++;
+
+    int first = Digits::digit(A[0], level);
+    if (counts[first] < n)
+      break;
+    if (Digits::finished(first, level))
+      return; // every key is equal
+    level++;
+  }
+
+  long sum = 0;
+  for (int b = 0; b < Digits::buckets; b++) {
+    next[b] = sum;
+    sum += counts[b];
+    ends[b] = sum;
+  }
+
+  for (int b = 0; b < Digits::buckets; b++)
+    while (next[b] < ends[b]) {
+      T val = A[next[b]];
+      int d = Digits::digit(val, level);
+      while (d != b) {
+        swap(val, A[next[d]++]);
+        d = Digits::digit(val, level);
+      }
+      A[next[b]++] = val;
+    }
+
+  auto sortBucket = [&](int b) {
+    if (counts[b] > 1 && !Digits::finished(b, level))
+      msdRadixSort(A + ends[b] - counts[b], counts[b], level + 1, pool);
+  };
+
+  if (pool == nullptr) {
+    for (int b = 0; b < Digits::buckets; b++)
+      sortBucket(b);
+    return;
+  }
+
+  TaskGroup group(*pool);
+  for (int b = 0; b < Digits::buckets; b++)
+    if (counts[b] > MSD_PARALLEL_CUTOFF)
+      group.run([&sortBucket, b]() { sortBucket(b); });
+    else
+      sortBucket(b);
+  group.wait();
+}
+
+/*
+Description: Sorts the array using an in-place MSD radix sort.
+Parameters: Array A, size of the array, and the number of threads to use.
+Return: None
+Notes: This is for integer data only; string arrays use the overload below.
+*/
+template <class T> void msdRadixSort(T A[], long n, int threads) {
+  static_assert(is_integral<T>::value, "msdRadixSort needs integer keys");
+  if (threads <= 1) {
+    msdRadixSort(A, n, 0, nullptr);
+    return;
+  }
+
+  WorkStealingPool pool(threads);
+  msdRadixSort(A, n, 0, &pool);
+}
+
+/*
+Description: Sorts an array of strings using an in-place MSD radix sort.
+Parameters: Array A, size of the array, and the number of threads to use.
+Return: None
+*/
+inline void msdRadixSort(string A[], long n, int threads) {
+  if (threads <= 1) {
+    msdRadixSort(A, n, 0, nullptr);
+    return;
+  }
+
+  WorkStealingPool pool(threads);
+  msdRadixSort(A, n, 0, &pool);
+}
+
+///////////////////////////////////////////////////////////
+//  Count Sort: implementation for integer data.
+///////////////////////////////////////////////////////////
+
+// Key ranges wider than this many counters per entry go to radix sort.
+const long COUNT_MAX_RANGE_RATIO = 4;
+// Ranges up to this size are always counted, however few entries there are.
+const long COUNT_SMALL_RANGE = 1 << 16;
+// Arrays at or below this size are counted on a single thread.
+const long COUNT_PARALLEL_CUTOFF = 1 << 16;
+
+/*
+Description: Runs f(0), ..., f(parts - 1), on the pool when there is one.
+Parameters: Number of parts, pool (nullptr for the calling thread) and f.
+Return: None
+*/
+template <class F> void runParts(int parts, WorkStealingPool *pool, F f) {
+  if (pool == nullptr) {
+    for (int t = 0; t < parts; t++)
+      f(t);
+    return;
+  }
+
+  TaskGroup group(*pool);
+  for (int t = 0; t < parts; t++)
+    group.run([&f, t]() { f(t); });
+  group.wait();
+}
+
+/*
+Description: Key range of an integer array for counting. The minimum and
+maximum are found in one pass written as two independent reductions, which
+the compiler vectorizes.
+*/
+template <class T> struct CountRange {
+  typedef typename make_unsigned<T>::type U;
+
+  T low;
+  unsigned long long span; // maximum - minimum, as an unsigned distance
+
+  CountRange(const T A[], long sz) {
+    T lo = A[0], hi = A[0];
+    for (long i = 1; i < sz; i++) {
+      lo = A[i] < lo ? A[i] : lo;
+      hi = A[i] > hi ? A[i] : hi;
+    }
+    low = lo;
+    span = static_cast<U>(radixKey(hi) - radixKey(lo));
+  }
+
+  // counting is worth it when there are few counters per entry
+  bool countable(long sz) const {
+    return span < static_cast<unsigned long long>(
+                      max(COUNT_SMALL_RANGE, COUNT_MAX_RANGE_RATIO * sz));
+  }
+
+  long slot(const T &x) const {
+    return static_cast<U>(radixKey(x) - radixKey(low));
+  }
+
+  T value(long v) const {
+    return static_cast<T>(static_cast<U>(low) + static_cast<U>(v));
+  }
+};
+
+/*
+Description: Counting stage shared by countsort, countsortByKey and
+BucketSort; bounds maps every key to a slot below range. The array is cut
+into parts blocks, each block is counted into its own histogram, and the
+histograms are turned into starting positions with a parallel prefix sum:
+every part sums a slice of the key range, the slice sums are scanned, and
+every part then fills in its slice. Position counts[t * range + v] is where
+part t writes its first key of slot v, so scattering the blocks in order is
+stable.
+Parameters: Array A, size, slot mapping, number of slots, number of parts
+and the pool.
+Return: The positions, one histogram of range slots per part.
+*/
+template <class T, class Slots>
+vector<long> countPositions(const T A[], long sz, const Slots &bounds,
+                            long range, int parts, WorkStealingPool *pool) {
+  vector<long> counts(parts * range, 0);
+
+  runParts(parts, pool, [&](int t) {
+    long *count = &counts[t * range];
+    for (long i = sz * t / parts; i < sz * (t + 1) / parts; i++)
+      count[bounds.slot(A[i])]++;
+  });
+
+  vector<long> sliceSum(parts + 1, 0);
+  runParts(parts, pool, [&](int c) {
+    long sum = 0;
+    for (long v = range * c / parts; v < range * (c + 1) / parts; v++)
+      for (int t = 0; t < parts; t++)
+        sum += counts[t * range + v];
+    sliceSum[c + 1] = sum;
+  });
+
+  for (int c = 0; c < parts; c++)
+    sliceSum[c + 1] += sliceSum[c];
+
+  runParts(parts, pool, [&](int c) {
+    long sum = sliceSum[c];
+    for (long v = range * c / parts; v < range * (c + 1) / parts; v++)
+      for (int t = 0; t < parts; t++) {
+        long count = counts[t * range + v];
+        counts[t * range + v] = sum;
+        sum += count;
+      }
+  });
+
+  return counts;
+}
+
+/*
+Description: Number of histograms to count with. Each part costs range
+counters, so parts are limited to about COUNT_MAX_RANGE_RATIO counters per
+entry in total.
+Parameters: Size, key range and the number of threads available.
+Return: Number of parts.
+*/
+inline int countParts(long sz, long range, int threads) {
+  if (threads <= 1 || sz <= COUNT_PARALLEL_CUTOFF)
+    return 1;
+  return static_cast<int>(
+      max(1L, min(static_cast<long>(threads),
+                  COUNT_MAX_RANGE_RATIO * sz / range)));
+}
+
+/*
+Description: Writes the sorted keys straight from the positions: slot v
+fills A from its first position up to the next slot's first position.
+Parameters: Array A, size, key range, positions and the pool to use.
+Return: None
+*/
+template <class T>
+void fillCounted(T A[], long sz, const CountRange<T> &bounds, long range,
+                 const vector<long> &counts, int parts,
+                 WorkStealingPool *pool) {
+  runParts(parts, pool, [&](int c) {
+    for (long v = range * c / parts; v < range * (c + 1) / parts; v++) {
+      long end = v + 1 < range ? counts[v + 1] : sz;
+      fill(A + counts[v], A + end, bounds.value(v));
+    }
+  });
+}
+
+/*
+Description: Sorts the array using a count sort over the range between the
+smallest and largest key, so negative keys and keys far from zero work.
+Parameters: Array A, the size of the array and the number of threads.
+Return: None
+Notes: This is for integer data only. Since equal keys are indistinguishable
+the sorted keys are written straight from the counts, with no temp array.
+When the range is wider than COUNT_MAX_RANGE_RATIO counters per entry (and
+more than COUNT_SMALL_RANGE) the array is radix sorted instead.
+*/
+template <class T> void countsort(T *A, long sz, int threads) {
+  static_assert(is_integral<T>::value, "countsort needs integer keys");
+  if (sz < 2)
+    return;
+
+  CountRange<T> bounds(A, sz);
+  if (!bounds.countable(sz)) {
+    lsdRadixSort(A, sz, 8);
+    return;
+  }
+
+  long range = bounds.span + 1;
+  int parts = countParts(sz, range, threads);
+  unique_ptr<WorkStealingPool> pool;
+  if (parts > 1)
+    pool.reset(new WorkStealingPool(parts));
+
+  vector<long> counts = countPositions(A, sz, bounds, range, parts, pool.get());
+  fillCounted(A, sz, bounds, range, counts, parts, pool.get());
+}
+
+/*
+Description: Stable count sort of integer keys that moves a value array with
+them. Each part scatters the values of its block to the positions from
+countPositions, and the keys are written from the counts as in countsort.
+Parameters: Keys, values, size and the number of threads.
+Return: None
+Notes: Too wide a key range falls back to radixSortByKey.
+*/
+template <class K, class V>
+void countsortByKey(K keys[], V values[], long sz, int threads) {
+  static_assert(is_integral<K>::value, "countsortByKey needs integer keys");
+  if (sz < 2)
+    return;
+
+  CountRange<K> bounds(keys, sz);
+  if (!bounds.countable(sz)) {
+    radixSortByKey(keys, values, static_cast<int>(sz));
+    return;
+  }
+
+  long range = bounds.span + 1;
+  int parts = countParts(sz, range, threads);
+  unique_ptr<WorkStealingPool> pool;
+  if (parts > 1)
+    pool.reset(new WorkStealingPool(parts));
+
+  vector<long> counts =
+      countPositions(keys, sz, bounds, range, parts, pool.get());
+  vector<V> sortedValues(sz);
+  vector<long> next = counts;
+  runParts(parts, pool.get(), [&](int t) {
+    long *position = &next[t * range];
+    for (long i = sz * t / parts; i < sz * (t + 1) / parts; i++)
+      sortedValues[position[bounds.slot(keys[i])]++] = values[i];
+  });
+
+  fillCounted(keys, sz, bounds, range, counts, parts, pool.get());
+  runParts(parts, pool.get(), [&](int t) {
+    copy(sortedValues.begin() + sz * t / parts,
+         sortedValues.begin() + sz * (t + 1) / parts, values + sz * t / parts);
+  });
+}
+
+///////////////////////////////////////////////////////////
+//  Bucket Sort: implementation for floating point data.
+///////////////////////////////////////////////////////////
+
+// Average number of keys per bucket.
+const long BUCKET_AVERAGE = 16;
+// Buckets at or below this size are finished by the leaf sort.
+const long BUCKET_LEAF = 64;
+// Levels of bucketing before a bucket is handed to introSort.
+const int BUCKET_MAX_DEPTH = 4;
+// Most buckets in the parallel first level; every part counts its own
+// histogram of them, and the buckets are split again by bucketRange.
+const long BUCKET_PARALLEL_SLOTS = 1 << 12;
+
+/*
+Description: Linear map from the key range [low, high] onto bucket numbers.
+Since subtracting low and scaling never reverse the order of two keys, the
+buckets come out in key order. A span too wide (overflowing to infinity) or
+too narrow (a denormal span makes the scale infinite) cannot be mapped, and
+usable() is false.
+*/
+template <class T> struct BucketMap {
+  double low;
+  double scale;
+  long buckets;
+
+  BucketMap(T lo, T hi, long m)
+      : low(lo), scale(m / (double(hi) - double(lo))), buckets(m) {}
+
+  bool usable() const { return scale > 0 && isfinite(scale); }
+
+  long slot(const T &x) const {
+    long b = static_cast<long>((double(x) - low) * scale);
+    return b < 0 ? 0 : (b < buckets ? b : buckets - 1);
+  }
+};
+
+/*
+Description: Finds the smallest and largest keys of a range.
+Parameters: Array A, size, and the variables that receive the results.
+Return: None
+*/
+template <class T> void bucketBounds(const T A[], long sz, T &lo, T &hi) {
+  lo = hi = A[0];
+  for (long i = 1; i < sz; i++) {
+    lo = A[i] < lo ? A[i] : lo;
+    hi = A[i] > hi ? A[i] : hi;
+  }
+}
+
+/*
+Description: Recursive portion of the bucket sort. The bucket boundaries
+come from the range's own minimum and maximum, the bucket sizes are counted
+in a first pass, and a second pass scatters the keys into the contiguous
+scratch array, which is copied back. Every bucket is then sorted the same
+way, so a bucket that a skewed distribution filled up is split again over
+its own, narrower key range. Small buckets go to the leaf sort, and buckets
+still too large after BUCKET_MAX_DEPTH levels go to introSort.
+Parameters: Array A, scratch array of the same size, size and depth.
+Return: None
+*/
+template <class T> void bucketRange(T A[], T Temp[], long sz, int depth) {
+  if (sz <= BUCKET_LEAF) {
+    smallSort(A, static_cast<int>(sz));
+    return;
+  }
+
+  T lo, hi;
+  bucketBounds(A, sz, lo, hi);
+  if (!(lo < hi))
+    return; // every key is equal
+  long m = sz / BUCKET_AVERAGE + 1;
+  BucketMap<T> map(lo, hi, m);
+  if (depth == BUCKET_MAX_DEPTH || !map.usable()) {
+    introSort(A, static_cast<int>(sz));
+    return;
+  }
+
+  vector<long> starts = countPositions(A, sz, map, m, 1, nullptr);
+  vector<long> next = starts;
+  for (long i = 0; i < sz; i++)
+    Temp[next[map.slot(A[i])]++] = A[i];
+  copy(Temp, Temp + sz, A);
+
+  for (long b = 0; b < m; b++) {
+    long end = b + 1 < m ? starts[b + 1] : sz;
+    bucketRange(A + starts[b], Temp + starts[b], end - starts[b], depth + 1);
+  }
+}
+
+/*
+Description: Sorts the array using a bucket sort over the range between its
+smallest and largest keys.
+Parameters: Array A, the size of the array and the number of threads.
+Return: None
+Notes: Works for any finite float or double range (and for integer keys).
+Apart from the bucket counts the only allocation is one scratch array of
+size sz. With threads the first level has at most BUCKET_PARALLEL_SLOTS
+buckets, is counted into per-part histograms and scattered in parallel like
+countsortByKey, and groups of buckets are then sorted as tasks on the pool.
+Keys must not be NaN; ranges with an infinite key or a denormal span are
+sorted by introSort.
+*/
+template <class T> void BucketSort(T *A, long sz, int threads) {
+  if (sz < 2)
+    return;
+
+  vector<T> Temp(sz);
+  if (threads <= 1 || sz <= COUNT_PARALLEL_CUTOFF) {
+    bucketRange(A, Temp.data(), sz, 0);
+    return;
+  }
+
+  WorkStealingPool pool(threads);
+  vector<T> partLo(threads), partHi(threads);
+  runParts(threads, &pool, [&](int t) {
+    long first = sz * t / threads;
+    bucketBounds(A + first, sz * (t + 1) / threads - first, partLo[t],
+                 partHi[t]);
+  });
+
+  T lo, hi, unused;
+  bucketBounds(partLo.data(), threads, lo, unused);
+  bucketBounds(partHi.data(), threads, unused, hi);
+  if (!(lo < hi))
+    return;
+  long m = min(sz / BUCKET_AVERAGE + 1, BUCKET_PARALLEL_SLOTS);
+  BucketMap<T> map(lo, hi, m);
+  if (!map.usable()) {
+    introSort(A, static_cast<int>(sz));
+    return;
+  }
+
+  int parts = countParts(sz, m, threads);
+  vector<long> next = countPositions(A, sz, map, m, parts, &pool);
+  vector<long> starts(next.begin(), next.begin() + m);
+  runParts(parts, &pool, [&](int t) {
+    long *position = &next[t * m];
+    for (long i = sz * t / parts; i < sz * (t + 1) / parts; i++)
+      Temp[position[map.slot(A[i])]++] = A[i];
+  });
+
+  // groups of buckets small enough for the pool to balance
+  int groups = threads * 8;
+  runParts(groups, &pool, [&](int g) {
+    for (long b = m * g / groups; b < m * (g + 1) / groups; b++) {
+      long end = b + 1 < m ? starts[b + 1] : sz;
+      copy(Temp.begin() + starts[b], Temp.begin() + end, A + starts[b]);
+      bucketRange(A + starts[b], Temp.data() + starts[b], end - starts[b], 1);
+    }
+  });
+}
+
+///////////////////////////////////////////////////////////
+//  Key-Value Sorts: sort_by_key and argsort
+///////////////////////////////////////////////////////////
+
+// Values wider than this are not moved by the sorts; the sort carries int
+// positions instead and the values are gathered once at the end.
+const size_t BY_KEY_MAX_PAYLOAD = sizeof(int);
+
+/*
+Description: Applies a permutation: dest[i] = source[index[i]].
+Parameters: Source array, index array, destination array and size.
+Return: None
+Notes: dest must not overlap source. Used to reorder any number of column
+arrays by one argsort result.
+*/
+template <class T>
+void gather(const T source[], const int index[], T dest[], int n) {
+  for (int i = 0; i < n; i++)
+    dest[i] = source[index[i]];
+}
+
+/*
+Description: Reorders values in place through a temporary copy, using an
+index array from argsort.
+Parameters: Values, index array and size.
+Return: None
+*/
+template <class V> void gatherInPlace(V values[], const int index[], int n) {
+  vector<V> copyOf(values, values + n);
+  gather(copyOf.data(), index, values, n);
+}
+
+/*
+Description: Insertion sort of keys that moves the values in lockstep.
+Parameters: Keys, values and size.
+Return: None
+Notes: Stable.
+*/
+template <class K, class V> void insertionByKey(K keys[], V values[], int n) {
+  for (int i = 1; i < n; i++) {
+    K key = keys[i];
+    V value = values[i];
+    int j = i;
+    for (; j > 0 && key < keys[j - 1]; j--) {
+      keys[j] = keys[j - 1];
+      values[j] = values[j - 1];
+    }
+    keys[j] = key;
+    values[j] = value;
+  }
+}
+
+/*
+Description: Bottom-up merge sort on the keys, with the values merged in
+lockstep. Like bottomUpMergeSort the two buffers swap roles each pass, and
+run pairs that are already in order are copied without comparisons.
+Parameters: Keys, values and size.
+Return: None
+Notes: Stable. Wide values are sorted as positions and gathered once.
+*/
+template <class K, class V>
+void mergeSortByKey(K keys[], V values[], int n) {
+  if (n < 2)
+    return;
+
+  if (sizeof(V) > BY_KEY_MAX_PAYLOAD) {
+    vector<int> index = mergeArgsort(keys, n);
+    gatherInPlace(keys, index.data(), n);
+    gatherInPlace(values, index.data(), n);
+    return;
+  }
+
+  for (int start = 0; start < n; start += MERGE_RUN)
+    insertionByKey(keys + start, values + start, min(MERGE_RUN, n - start));
+
+  vector<K> keyBuffer(n);
+  vector<V> valueBuffer(n);
+  K *srcK = keys, *dstK = keyBuffer.data();
+  V *srcV = values, *dstV = valueBuffer.data();
+
+  for (int width = MERGE_RUN; width < n; width *= 2) {
+    for (int lo = 0; lo < n; lo += 2 * width) {
+      int mid = min(lo + width, n);
+      int hi = min(lo + 2 * width, n);
+      if (mid == hi || !(srcK[mid] < srcK[mid - 1])) {
+        copy(srcK + lo, srcK + hi, dstK + lo); // already in order
+        copy(srcV + lo, srcV + hi, dstV + lo);
+        continue;
+      }
+
+      int a = lo, b = mid, i = lo;
+      while (a < mid && b < hi)
+        if (srcK[b] < srcK[a]) {
+          dstK[i] = srcK[b];
+          dstV[i++] = srcV[b++];
+        } else {
+          dstK[i] = srcK[a];
+          dstV[i++] = srcV[a++];
+        }
+      copy(srcK + a, srcK + mid, dstK + i);
+      copy(srcV + a, srcV + mid, dstV + i);
+      i += mid - a;
+      copy(srcK + b, srcK + hi, dstK + i);
+      copy(srcV + b, srcV + hi, dstV + i);
+    }
+    swap(srcK, dstK);
+    swap(srcV, dstV);
+  }
+
+  if (srcK != keys) {
+    copy(srcK, srcK + n, keys);
+    copy(srcV, srcV + n, values);
+  }
+}
+
+/*
+Description: Recursive portion of quickSortByKey: the introSort scheme with
+the values swapped along with their keys. Once the depth limit is used up
+the range is finished by mergeSortByKey.
+Parameters: Keys, values, starting and ending positions of the range, and
+the number of partitioning levels left.
+Return: None
+*/
+template <class K, class V>
+void quickSortByKey(K keys[], V values[], int left, int right,
+                    int depthLimit) {
+  while (right - left + 1 > INTROSORT_THRESHOLD) {
+    if (depthLimit == 0) {
+      mergeSortByKey(keys + left, values + left, right - left + 1);
+      return;
+    }
+    depthLimit--;
+
+    K pivot = keys[choosePivot(keys, left, right)];
+    int i = left, j = right;
+    while (i <= j) {
+      while (keys[i] < pivot)
+        i++;
+      while (pivot < keys[j])
+        j--;
+      if (i <= j) {
+        swap(keys[i], keys[j]);
+        swap(values[i++], values[j--]);
+      }
+    }
+
+    if (j - left < right - i) {
+      quickSortByKey(keys, values, left, j, depthLimit);
+      left = i;
+    } else {
+      quickSortByKey(keys, values, i, right, depthLimit);
+      right = j;
+    }
+  }
+  insertionByKey(keys + left, values + left, right - left + 1);
+}
+
+/*
+Description: Sorts the keys with an intro sort, moving the values along.
+Parameters: Keys, values and size.
+Return: None
+Notes: Not stable. Wide values are sorted as positions and gathered once.
+*/
+template <class K, class V>
+void quickSortByKey(K keys[], V values[], int n) {
+  if (n < 2)
+    return;
+
+  if (sizeof(V) > BY_KEY_MAX_PAYLOAD) {
+    vector<int> index = quickArgsort(keys, n);
+    gatherInPlace(keys, index.data(), n);
+    gatherInPlace(values, index.data(), n);
+    return;
+  }
+
+  int depthLimit = 0;
+  for (int size = n; size > 1; size /= 2)
+    depthLimit += 2;
+
+  quickSortByKey(keys, values, 0, n - 1, depthLimit);
+}
+
+/*
+Description: LSD radix sort on integer keys that scatters the values with
+their keys. The histograms are built from the key array alone, and passes
+where every key has the same digit are skipped, as in lsdRadixSort.
+Parameters: Keys, values and size.
+Return: None
+Notes: Stable; for integer keys only. Wide values are sorted as positions
+and gathered once.
+*/
+template <class K, class V>
+void radixSortByKey(K keys[], V values[], int n) {
+  static_assert(is_integral<K>::value, "radixSortByKey needs integer keys");
+  typedef typename make_unsigned<K>::type U;
+
+  if (n < 2)
+    return;
+
+  if (sizeof(V) > BY_KEY_MAX_PAYLOAD) {
+    vector<int> index = radixArgsort(keys, n);
+    gatherInPlace(keys, index.data(), n);
+    gatherInPlace(values, index.data(), n);
+    return;
+  }
+
+  const int digitBits = 8;
+  const int passes = sizeof(K);
+  const int buckets = 1 << digitBits;
+
+  vector<int> counts(passes * buckets, 0);
+  for (int i = 0; i < n; i++) {
+    U key = radixKey(keys[i]);
+    for (int p = 0; p < passes; p++)
+      counts[p * buckets + ((key >> (p * digitBits)) & (buckets - 1))]++;
+  }
+
+  vector<K> keyBuffer(n);
+  vector<V> valueBuffer(n);
+  K *srcK = keys, *dstK = keyBuffer.data();
+  V *srcV = values, *dstV = valueBuffer.data();
+
+  for (int p = 0; p < passes; p++) {
+    int shift = p * digitBits;
+    int *offsets = &counts[p * buckets];
+    if (offsets[(radixKey(srcK[0]) >> shift) & (buckets - 1)] == n)
+      continue; // every key has the same digit
+
+    int sum = 0;
+    for (int b = 0; b < buckets; b++) {
+      int count = offsets[b];
+      offsets[b] = sum;
+      sum += count;
+    }
+
+    for (int i = 0; i < n; i++) {
+      int pos = offsets[(radixKey(srcK[i]) >> shift) & (buckets - 1)]++;
+      dstK[pos] = srcK[i];
+      dstV[pos] = srcV[i];
+    }
+    swap(srcK, dstK);
+    swap(srcV, dstV);
+  }
+
+  if (srcK != keys) {
+    copy(srcK, srcK + n, keys);
+    copy(srcV, srcV + n, values);
+  }
+}
+
+/*
+Description: Sorts keys and values by key with the best path for the key
+type: radix sort for integer keys and merge sort otherwise.
+Parameters: Keys, values and size.
+Return: None
+Notes: Stable.
+*/
+template <class K, class V> void sortByKey(K keys[], V values[], int n) {
+  if constexpr (is_integral<K>::value)
+    radixSortByKey(keys, values, n);
+  else
+    mergeSortByKey(keys, values, n);
+}
+
+/*
+Description: Argsort variants. Each sorts a copy of the keys with the
+positions 0 .. n - 1 as values, and returns the positions in sorted order,
+so that gather(column, index, out, n) puts any column array in key order.
+Parameters: Keys and size.
+Return: Index array of size n.
+Notes: mergeArgsort and radixArgsort are stable, so equal keys keep their
+original order; quickArgsort is not.
+*/
+template <class K> vector<int> mergeArgsort(const K keys[], int n) {
+  vector<K> keyCopy(keys, keys + n);
+  vector<int> index(n);
+  for (int i = 0; i < n; i++)
+    index[i] = i;
+  mergeSortByKey(keyCopy.data(), index.data(), n);
+  return index;
+}
+
+template <class K> vector<int> quickArgsort(const K keys[], int n) {
+  vector<K> keyCopy(keys, keys + n);
+  vector<int> index(n);
+  for (int i = 0; i < n; i++)
+    index[i] = i;
+  quickSortByKey(keyCopy.data(), index.data(), n);
+  return index;
+}
+
+template <class K> vector<int> radixArgsort(const K keys[], int n) {
+  vector<K> keyCopy(keys, keys + n);
+  vector<int> index(n);
+  for (int i = 0; i < n; i++)
+    index[i] = i;
+  radixSortByKey(keyCopy.data(), index.data(), n);
+  return index;
+}
+
+template <class K> vector<int> argsort(const K keys[], int n) {
+  if constexpr (is_integral<K>::value)
+    return radixArgsort(keys, n);
+  else
+    return mergeArgsort(keys, n);
+}
+
+///////////////////////////////////////////////////////////
+//  Generic Sort: comparators, projections and dispatch
+///////////////////////////////////////////////////////////
+
+// Integer ranges above this size with the default ordering are radix sorted.
+const size_t GENERIC_RADIX_CUTOFF = 1024;
+
+// Projection that hands the element to the comparator unchanged.
+struct Identity {
+  template <class U> constexpr U &&operator()(U &&x) const noexcept {
+    return std::forward<U>(x);
+  }
+};
+
+// Sort on the calling thread.
+struct SequentialPolicy {};
+
+// Sort on up to threads threads.
+struct ParallelPolicy {
+  int threads;
+};
+
+/*
+Description: Comparator and projection folded into one less-than, so the
+sorts below see a single callable. Both are stored by value and called
+directly, so the compiler can inline them.
+Notes: The projection may be any callable or a pointer to member, as with
+std::invoke.
+*/
+template <class Compare, class Project> struct ProjectedLess {
+  Compare comp;
+  Project proj;
+
+  template <class A, class B> bool operator()(const A &a, const B &b) const {
+    return invoke(comp, invoke(proj, a), invoke(proj, b));
+  }
+};
+
+/*
+Description: Whether a comparator and projection give the natural ascending
+order of T, which is what the radix sorts and sorting networks produce.
+*/
+template <class T, class Compare, class Project>
+struct isDefaultOrder
+    : integral_constant<bool, is_same<Project, Identity>::value &&
+                                  (is_same<Compare, less<>>::value ||
+                                   is_same<Compare, less<T>>::value)> {};
+
+/*
+Description: Comparison path of the front end: pdqSort, with the branchless
+partition when comp is a standard ordering on an arithmetic type and there
+is no projection.
+Parameters: Range [first, last), the comparator, projection and policy.
+Return: None
+*/
+template <class It, class Compare, class Project, class Policy>
+void genericComparisonSort(It first, It last, Compare comp, Project proj,
+                           Policy policy) {
+  typedef typename iterator_traits<It>::value_type T;
+  int threads = 1;
+  if constexpr (is_same<Policy, ParallelPolicy>::value)
+    threads = policy.threads;
+
+  if constexpr (is_same<Project, Identity>::value) {
+    pdqSort<pdqBranchless<Compare, T>::value>(first, last, comp, threads);
+  } else {
+    pdqSort<false>(first, last, ProjectedLess<Compare, Project>{comp, proj},
+                   threads);
+  }
+}
+
+/*
+Description: Sorts [first, last) by comp applied to proj of each entry.
+The path is picked at compile time from the element type, comparator and
+projection: with the natural ascending order, integers go to LSD radix sort
+(MSD radix sort on several threads) above GENERIC_RADIX_CUTOFF, and int,
+float and double arrays of up to NETWORK_MAX_BLOCK entries go to a SIMD
+sorting network; everything else goes to pdqSort.
+Parameters: Range [first, last), the comparator (less<> by default), the
+projection (Identity by default) and the policy (SequentialPolicy or
+ParallelPolicy).
+Return: None
+Notes: Not stable. Lengths are size_t on the comparison path, so ranges past
+2^31 entries are fine there; integer ranges longer than the largest long
+(2^31 - 1 where long is 32 bits, as with MinGW) skip the radix sorts and
+take pdqSort.
+*/
+template <class T, class Compare, class Project, class Policy>
+void genericSort(T *first, T *last, Compare comp, Project proj, Policy policy) {
+  size_t n = last - first;
+  if (n < 2)
+    return;
+
+  if constexpr (isDefaultOrder<T, Compare, Project>::value) {
+    if constexpr (hasSortingNetwork<T>::value) {
+      if (n <= static_cast<size_t>(NETWORK_MAX_BLOCK) &&
+          networkSort(first, static_cast<int>(n)))
+        return;
+    }
+    if constexpr (is_integral<T>::value && !is_same<T, bool>::value) {
+      // the radix sorts take long lengths, which are 32 bits on Windows
+      if (n > GENERIC_RADIX_CUTOFF &&
+          n <= static_cast<size_t>(numeric_limits<long>::max())) {
+        int threads = 1;
+        if constexpr (is_same<Policy, ParallelPolicy>::value)
+          threads = policy.threads;
+        if (threads > 1)
+          msdRadixSort(first, static_cast<long>(n), threads);
+        else
+          lsdRadixSort(first, static_cast<long>(n), sizeof(T) > 2 ? 11 : 8);
+        return;
+      }
+    }
+  }
+
+  genericComparisonSort(first, last, comp, proj, policy);
+}
+
+/*
+Description: Iterator overload of the front end. Contiguous ranges are
+passed on to the pointer overload; other random access iterators, such as
+those of deque, take pdqSort.
+Parameters: As for the pointer overload.
+Return: None
+*/
+template <class It, class Compare = less<>, class Project = Identity,
+          class Policy = SequentialPolicy,
+          class = typename enable_if<
+              !is_pointer<It>::value &&
+              is_base_of<random_access_iterator_tag,
+                         typename iterator_traits<It>::iterator_category>::
+                  value>::type>
+void genericSort(It first, It last, Compare comp = Compare(),
+                 Project proj = Project(), Policy policy = Policy()) {
+  typedef typename iterator_traits<It>::value_type T;
+  if constexpr (is_same<It, typename vector<T>::iterator>::value &&
+                !is_same<T, bool>::value) {
+    if (first != last)
+      genericSort(&*first, &*first + (last - first), comp, proj, policy);
+  } else {
+    if (last - first > 1)
+      genericComparisonSort(first, last, comp, proj, policy);
+  }
+}
+
+/*
+Description: Span overload of the front end: sorts any contiguous container
+or view with data() and size(), such as vector, array or string.
+Parameters: The range, then as for the pointer overload.
+Return: None
+*/
+template <class Range, class Compare = less<>, class Project = Identity,
+          class Policy = SequentialPolicy,
+          class = decltype(declval<Range &>().data() +
+                           declval<Range &>().size())>
+void genericSort(Range &&range, Compare comp = Compare(),
+                 Project proj = Project(), Policy policy = Policy()) {
+  genericSort(range.data(), range.data() + range.size(), comp, proj, policy);
 }
 
 #endif /* SORTS_H_ */
@@ -0,0 +1,200 @@
+/*
+Author: JJ McCauley
+Creation Date: 10/17/26
+Last Update: 10/17/26
+Description: Small work-stealing thread pool used by the parallel sorting
+routines in Sorts.h.
+Notes: Every worker owns a deque of tasks. A worker pushes and pops its own
+tasks at the back (newest first, which keeps recursive splits cache-warm) and
+steals from the front of other deques when its own runs dry. Threads that
+wait on a TaskGroup help run queued tasks instead of blocking, so nested
+fork/join recursion cannot deadlock the pool.
+*/
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class WorkStealingPool {
+public:
+  explicit WorkStealingPool(unsigned threads);
+  ~WorkStealingPool();
+
+  unsigned size() const { return numThreads; }
+  void submit(function<void()> task);
+  bool runPendingTask();
+
+private:
+  struct TaskQueue {
+    mutex lock;
+    deque<function<void()>> tasks;
+  };
+
+  unsigned numThreads;
+  vector<unique_ptr<TaskQueue>> queues; // queue 0 belongs to outside threads
+  vector<thread> workers;
+  atomic<bool> done;
+  atomic<long> queued;
+  mutex sleepLock;
+  condition_variable wake;
+
+  static thread_local WorkStealingPool *currentPool;
+  static thread_local unsigned currentIndex;
+
+  unsigned myQueue() const;
+  void workerLoop(unsigned index);
+};
+
+inline thread_local WorkStealingPool *WorkStealingPool::currentPool = nullptr;
+inline thread_local unsigned WorkStealingPool::currentIndex = 0;
+
+/*
+Description: Fork/join helper that tracks a set of tasks submitted to a pool.
+Notes: wait() runs pending pool tasks while the group is unfinished, so the
+calling thread counts as one of the pool's threads.
+*/
+class TaskGroup {
+public:
+  explicit TaskGroup(WorkStealingPool &p) : pool(p), pending(0) {}
+  ~TaskGroup() { wait(); }
+
+  template <class F> void run(F task) {
+    pending++;
+    pool.submit([this, task]() {
+      task();
+      pending--;
+    });
+  }
+
+  void wait() {
+    while (pending > 0)
+      if (!pool.runPendingTask())
+        this_thread::yield();
+  }
+
+private:
+  WorkStealingPool &pool;
+  atomic<long> pending;
+};
+
+/*
+Description: Starts threads - 1 worker threads; the thread that waits on the
+work supplies the last one.
+Parameters: Total number of threads that should work on submitted tasks.
+Return: None
+*/
+inline WorkStealingPool::WorkStealingPool(unsigned threads)
+    : numThreads(threads < 1 ? 1 : threads), done(false), queued(0) {
+  for (unsigned i = 0; i < numThreads; i++)
+    queues.push_back(unique_ptr<TaskQueue>(new TaskQueue));
+
+  for (unsigned i = 1; i < numThreads; i++)
+    workers.push_back(thread(&WorkStealingPool::workerLoop, this, i));
+}
+
+/*
+Description: Stops and joins the worker threads.
+Parameters: None
+Return: None
+*/
+inline WorkStealingPool::~WorkStealingPool() {
+  {
+    lock_guard<mutex> guard(sleepLock);
+    done = true;
+  }
+  wake.notify_all();
+  for (unsigned i = 0; i < workers.size(); i++)
+    workers[i].join();
+}
+
+/*
+Description: Index of the deque owned by the calling thread.
+Parameters: None
+Return: Queue index, 0 for threads that are not workers of this pool.
+*/
+inline unsigned WorkStealingPool::myQueue() const {
+  return currentPool == this ? currentIndex : 0;
+}
+
+/*
+Description: Queues a task on the calling thread's deque.
+Parameters: Task to run.
+Return: None
+*/
+inline void WorkStealingPool::submit(function<void()> task) {
+  TaskQueue &q = *queues[myQueue()];
+  {
+    lock_guard<mutex> guard(q.lock);
+    q.tasks.push_back(move(task));
+  }
+  {
+    lock_guard<mutex> guard(sleepLock);
+    queued++;
+  }
+  wake.notify_one();
+}
+
+/*
+Description: Runs one pending task, taking the newest task from the caller's
+own deque or stealing the oldest task from another deque.
+Parameters: None
+Return: True if a task was run.
+*/
+inline bool WorkStealingPool::runPendingTask() {
+  unsigned own = myQueue();
+  function<void()> task;
+
+  for (unsigned k = 0; k < numThreads && !task; k++) {
+    TaskQueue &q = *queues[(own + k) % numThreads];
+    lock_guard<mutex> guard(q.lock);
+    if (q.tasks.empty())
+      continue;
+
+    if (k == 0) {
+      task = move(q.tasks.back());
+      q.tasks.pop_back();
+    } else {
+      task = move(q.tasks.front());
+      q.tasks.pop_front();
+    }
+    queued--;
+  }
+
+  if (!task)
+    return false;
+
+  task();
+  return true;
+}
+
+/*
+Description: Main loop of a worker thread.
+Parameters: Index of the worker's deque.
+Return: None
+*/
+inline void WorkStealingPool::workerLoop(unsigned index) {
+  currentPool = this;
+  currentIndex = index;
+
+  while (true) {
+    if (runPendingTask())
+      continue;
+
+    unique_lock<mutex> guard(sleepLock);
+    wake.wait(guard, [this]() { return done || queued > 0; });
+    if (done)
+      return;
+  }
+}
+
+#endif /* THREADPOOL_H_ */